@@ -1,3 +1,7 @@
 
 unsigned int bcd_add(unsigned int a, unsigned int b);
 unsigned int bcd_add2(unsigned int a, unsigned int b);
+
+// add bcd (00..99) to a 6-digit packed BCD number
+// stored least significant byte first (bcd6.s)
+void __fastcall__ bcd_add6(unsigned char* dest, unsigned char bcd);
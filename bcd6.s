@@ -0,0 +1,62 @@
+;6-digit packed BCD add, least significant byte first
+;the 2A03 has no decimal mode, so each byte is added in
+;binary with 6 pre-added to both digits, and the 6 is taken
+;back out of every digit that didn't carry
+
+;void __fastcall__ bcd_add6(unsigned char* dest, unsigned char bcd);
+;adds bcd (00..99) to the 3-byte number at dest
+
+	.import popax
+	.importzp ptr1,tmp1,tmp2,tmp3,tmp4
+
+.segment "CODE"
+
+	.export _bcd_add6
+
+_bcd_add6:
+
+	sta tmp1		;addend for the lowest byte
+	jsr popax
+	sta ptr1
+	stx ptr1+1
+	ldy #0
+	sty tmp2		;no carry into the lowest byte
+
+@byte:
+
+	lda (ptr1),y
+	clc
+	adc #$66		;a+$66 never carries out, a<=$99
+	sta tmp3
+	lsr tmp2		;carry in
+	adc tmp1
+	sta tmp4		;binary sum
+	rol tmp2		;carry out of the high digit
+	eor tmp3
+	eor tmp1
+	and #$10		;carry out of the low digit
+	bne @lowCarry
+	lda tmp4
+	sec
+	sbc #$06
+	sta tmp4
+
+@lowCarry:
+
+	lda tmp2
+	bne @highCarry
+	lda tmp4
+	sec
+	sbc #$60
+	sta tmp4
+
+@highCarry:
+
+	lda tmp4
+	sta (ptr1),y
+	lda #0
+	sta tmp1		;higher bytes only add the carry
+	iny
+	cpy #3
+	bne @byte
+	rts
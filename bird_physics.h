@@ -0,0 +1,16 @@
+
+// generated by mkphysics.py from flappy.c, do not edit
+
+// frames from a flap to terminal velocity
+#define FALL_FRAMES 32
+// first frame of a flap with a downward velocity
+#define FALL_T_REST 16
+
+// bird velocity in 1/256 pixels per frame, t frames after a flap
+const int fall_v[FALL_FRAMES+1]={
+-1024,-960,-896,-832,-768,-704,-640,-576,
+-512,-448,-384,-320,-256,-192,-128,-64,
+0,64,128,192,256,320,384,448,
+512,576,640,704,768,832,896,960,
+1024,
+};
@@ -0,0 +1,97 @@
+;unrolled NMI upload of one pair of playfield columns
+;replaces two vertical runs plus six attribute writes in the
+;update buffer; the main loop fills in the variables below and
+;sets colblit_pending, the NMI callback uploads and clears it
+
+PPU_CTRL	=$2000
+PPU_SCROLL	=$2005
+PPU_ADDR	=$2006
+PPU_DATA	=$2007
+
+PLAYROWS	=27		;tiles per column, as in flappy.c
+ATTRROWS	=6		;attribute bytes per column
+
+	.import _famitone_update
+	.import _get_ppu_ctrl_var
+
+.segment "ZEROPAGE"
+
+_colblit_col1:		.res 2	;left column source
+_colblit_col2:		.res 2	;right column source
+
+.segment "BSS"
+
+_colblit_addr:		.res 2	;nametable address of left column
+_colblit_attraddr:	.res 2	;attribute table address of first byte
+_colblit_attr:		.res ATTRROWS
+_colblit_pending:	.res 1	;nonzero when there is a column to upload
+
+.segment "CODE"
+
+	.exportzp _colblit_col1,_colblit_col2
+	.export _colblit_addr,_colblit_attraddr,_colblit_attr
+	.export _colblit_pending
+	.export _colblit_nmi
+
+;NMI callback, runs after neslib's own updates, so it has to
+;put the PPU address and scroll back when done
+;leaves the status bar at scroll 0,0
+
+_colblit_nmi:
+
+	lda _colblit_pending
+	bne @upload
+	jmp _famitone_update
+
+@upload:
+
+	jsr _get_ppu_ctrl_var
+	pha
+	ora #$04		;+32 increment for vertical runs
+	sta PPU_CTRL
+
+	lda _colblit_addr+1
+	sta PPU_ADDR
+	lda _colblit_addr+0
+	sta PPU_ADDR
+	ldy #0
+	.repeat PLAYROWS
+	lda (_colblit_col1),y
+	sta PPU_DATA
+	iny
+	.endrepeat
+
+	lda _colblit_addr+1
+	sta PPU_ADDR
+	ldx _colblit_addr+0
+	inx			;right column is the next tile over
+	stx PPU_ADDR
+	ldy #0
+	.repeat PLAYROWS
+	lda (_colblit_col2),y
+	sta PPU_DATA
+	iny
+	.endrepeat
+
+	pla
+	sta PPU_CTRL		;back to +1 increment
+
+	ldy _colblit_attraddr+1
+	clc			;adds below never carry out of the attribute table
+	.repeat ATTRROWS,i
+	sty PPU_ADDR
+	lda _colblit_attraddr+0
+	adc #i*8
+	sta PPU_ADDR
+	lda _colblit_attr+i
+	sta PPU_DATA
+	.endrepeat
+
+	lda #0
+	sta _colblit_pending
+	sta PPU_ADDR
+	sta PPU_ADDR
+	sta PPU_SCROLL
+	sta PPU_SCROLL
+
+	jmp _famitone_update
@@ -0,0 +1,29 @@
+
+// generated by mkcollision.py from chr_generic.s, do not edit
+// one row per line, bit 15 (bit 7 for tiles) is the leftmost pixel
+
+const unsigned short bird_mask[16]={
+0x0000,0x03f0,0x0ff8,0x1ffc,0x7ffe,0xfffe,0xfffe,0xffff,
+0x7fff,0x3fff,0x3ffe,0x1ffe,0x07c0,0x0000,0x0000,0x0000,
+};
+
+const unsigned short birdFly_mask[16]={
+0x0000,0x03f0,0x0ff8,0x1ffc,0x3ffe,0x7ffe,0xfffe,0xffff,
+0x7fff,0x7fff,0x3ffe,0x1ffe,0x07c0,0x0000,0x0000,0x0000,
+};
+
+const unsigned short birdFly2_mask[16]={
+0x0000,0x03f0,0x0ff8,0x1ffc,0x3ffe,0x7ffe,0xfffe,0xffff,
+0xffff,0xffff,0x7ffe,0x1ffe,0x07c0,0x0000,0x0000,0x0000,
+};
+
+const unsigned short bird_down_mask[16]={
+0x00c0,0x03e0,0x07f0,0x0ff8,0x0ffc,0x1ffc,0x1ffe,0x1ffe,
+0x1ffe,0x1ffe,0x0ffe,0x0ffe,0x0ffc,0x0ff8,0x0ff0,0x0380,
+};
+
+const unsigned char pipe_tile_mask[3][8]={
+{0x3f,0x3f,0x3f,0x3f,0x3f,0x3f,0x3f,0x3f},
+{0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff},
+{0xfc,0xfc,0xfc,0xfc,0xfc,0xfc,0xfc,0xfc},
+};
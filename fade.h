@@ -0,0 +1,29 @@
+
+#ifndef _FADE_H
+#define _FADE_H
+
+// frames per brightness step for normal fades
+#define FADE_RATE 4
+
+// brightness state, stepped by fade_nmi (fade.s)
+extern unsigned char fade_bright;
+extern unsigned char fade_target;
+extern unsigned char fade_rate;
+
+// set the NMI callback to run after each fade step
+void __fastcall__ fade_set_chain(void (*f)(void));
+
+// NMI callback, set with nmi_set_callback after fade_set_chain
+void __fastcall__ fade_nmi(void);
+
+// set the brightness now, stopping any fade
+void __fastcall__ fade_set(unsigned char bright);
+
+// start fading to brightness to (0..8), one step every r frames
+// (r first, the NMI only looks at it once the target changes)
+#define fade_to(to,r) (fade_rate = (r), fade_target = (to))
+
+// true once the last fade has finished
+#define fade_done() (fade_bright == fade_target)
+
+#endif // fade.h
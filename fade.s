@@ -0,0 +1,78 @@
+;palette brightness fades stepped from the NMI, so the main
+;loop keeps running while the screen fades; the main loop sets
+;fade_rate and fade_target and polls fade_bright to see when
+;it gets there
+
+	.import _pal_bright
+
+.segment "BSS"
+
+_fade_bright:	.res 1	;brightness shown now, 0..8
+_fade_target:	.res 1	;brightness to fade to
+_fade_rate:	.res 1	;frames per step, 1 or more
+fade_timer:	.res 1	;frames left until the next step
+fade_chain:	.res 3	;jmp to the NMI callback to run afterwards
+
+.segment "CODE"
+
+	.export _fade_bright,_fade_target,_fade_rate
+	.export _fade_nmi,_fade_set,_fade_set_chain
+
+;NMI callback, steps the brightness once every fade_rate
+;frames, then jumps to fade_chain; pal_bright only touches
+;neslib's palette pointers, so it is safe to call from here
+;and takes effect at the next NMI
+;fade_chain is a jmp absolute with its operand patched by
+;fade_set_chain, a jmp (ind) through a pointer that ends up
+;straddling a page would read the wrong high byte
+
+_fade_nmi:
+
+	lda _fade_bright
+	cmp _fade_target
+	bne @fading
+	lda _fade_rate		;idle, a new fade waits a full step
+	sta fade_timer
+	jmp fade_chain
+
+@fading:
+
+	dec fade_timer
+	bne @done
+	lda _fade_rate
+	sta fade_timer
+	lda _fade_bright
+	cmp _fade_target
+	bcs @down
+	inc _fade_bright
+	bne @set		;always taken, brightness is 1..8 here
+@down:
+	dec _fade_bright
+@set:
+	lda _fade_bright
+	jsr _pal_bright
+
+@done:
+
+	jmp fade_chain
+
+;void __fastcall__ fade_set(unsigned char bright);
+;sets the brightness right away, cancelling any fade
+
+_fade_set:
+
+	sta _fade_target
+	sta _fade_bright
+	jmp _pal_bright
+
+;void __fastcall__ fade_set_chain(void (*f)(void));
+;sets the callback fade_nmi runs afterwards, call it
+;before nmi_set_callback(fade_nmi)
+
+_fade_set_chain:
+
+	sta fade_chain+1
+	stx fade_chain+2
+	lda #$4c		;jmp absolute
+	sta fade_chain
+	rts
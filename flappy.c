@@ -2,14 +2,17 @@
 #include "neslib.h"
 #include <stdlib.h>
 #include <string.h>
-#include "flappyBird_titlescreen.h"
-#include "flappyBird_titlescreen2.h"
+// title nametable, mktitle.py packs it from flappyBird_titlescreen.h
+// (flappyBird_titlescreen2.h is the same screen, byte for byte)
+#include "title_lz4.h"
 
 // 0 = horizontal mirroring
 // 1 = vertical mirroring
 #define NES_MIRRORING 1
-#define MAX_SPEED 8
-#define y_acceleration 2
+// bird physics, run mkphysics.py after changing these
+#define MAX_SPEED 8		// terminal velocity, 1/2 pixels per frame
+#define y_acceleration 2	// gravity, 1/8 pixels per frame per frame
+#define FLAP_SPEED 4		// speed right after a flap, pixels per frame
 
 // VRAM update buffer
 #include "vrambuf.h"
@@ -18,6 +21,38 @@
 // BCD arithmetic support
 #include "bcd.h"
 //#link "bcd.c"
+//#link "bcd6.s"
+
+// controller input recording and playback
+#include "replay.h"
+//#link "replay.c"
+
+// OAM allocation with priorities and flicker
+#include "sprites.h"
+//#link "sprites.c"
+
+// per-frame task scheduler
+#include "sched.h"
+//#link "sched.c"
+
+// LZ4 nametables a few rows at a time
+#include "lz4stream.h"
+//#link "lz4stream.c"
+
+// decode the title into the update buffer over the first frames
+// with rendering on, comment out to unpack it with rendering off
+#define TITLE_STREAM
+
+// title rows the NMI can copy per frame, with time to spare
+// (no palette updates go with them, see title_frame)
+#define TITLE_ROWS_PER_FRAME 2
+
+// palette fades run from the NMI
+#include "fade.h"
+//#link "fade.s"
+
+// profiling markers (build with -DPROFILE)
+#include "profile.h"
 
 // setup Famitone library
 //#link "famitone2.s"
@@ -27,6 +62,33 @@ extern char after_the_rain_music_data[];
 //#link "demosounds.s"
 extern char demo_sounds[];
 
+// unrolled NMI upload of scroll columns,
+// uncomment to use instead of the update buffer
+//#define COLUMN_BLIT
+//#link "colblit.s"
+void __fastcall__ colblit_nmi(void);
+extern const char* colblit_col1;
+extern const char* colblit_col2;
+#pragma zpsym ("colblit_col1")
+#pragma zpsym ("colblit_col2")
+extern word colblit_addr;
+extern word colblit_attraddr;
+extern char colblit_attr[];
+extern byte colblit_pending;
+
+// status bar split from an MMC3 scanline IRQ instead of the
+// sprite-zero wait in split(), uncomment both to build for MMC3
+//#define MMC3_SPLIT
+//#define NES_MAPPER 4
+#include "mmc3split.h"
+//#link "mmc3split.s"
+
+// metasprites compiled to straight-line code by mkmetaspr.py,
+// comment out to draw them from the tables instead
+#define COMPILED_SPRITES
+#include "metaspr.h"
+//#link "metaspr.s"
+
 // link the pattern table into CHR ROM
 //#link "chr_generic.s"
 //#include "flappyBird_PAL.pal"
@@ -37,28 +99,45 @@ extern char demo_sounds[];
 word x_scroll;		// X scroll amount in pixels
 byte seg_height;	// segment height in metatiles
 byte seg_height2;	// inverse segment height
-byte last_seg_height;	// remembers previous segment height;
 byte seg_width;		// segment width in metatiles of pipes
 byte seg_char;		// character to draw
 byte seg_palette;	// attribute table value
-byte high;		// high position of pipe opening
-byte low;		// low position of pipe opening
-byte x_pos;		// defines position by 8*8 tile
 byte x_exact_pos;	// defines positoin by exact pixel position
 byte gameover;		// stores state of game, gameover is 1
-word player_score;	// stores the player's score
+byte player_score[3];	// player's score, 6-digit packed BCD
+byte high_score[3];	// best score so far, same format
+byte score_shown[3];	// digits of player_score on screen
+byte high_shown[3];	// digits of high_score on screen
 char oam_id;		// ID of sprite
 char pad;		// needed to read controller input
 char last_controller_state; //keeps track of the previous controller input
+byte bird_t;		// frames since the last flap, up to FALL_FRAMES
+byte bird_yfrac;	// fractional part of the bird's y position
 char i;			// multi-use variable useful for loops
 byte direction;
+word rng_seed;		// seed for rand8; a harness may preset it before play
+word play_frames;	// frames survived in the current round
+byte scroll_speed;	// scroll speed in 1/16 pixels per frame
+byte scroll_frac;	// subpixel part of the scroll position
+byte scroll_px;		// whole pixels to scroll this frame
+byte actor_scroll;	// pixels scrolled since update_actors last ran
 
 
-static unsigned char bright;
 static unsigned char frame_cnt;
 static unsigned char wait;
+static byte retry_col;	// next metatile column retry_clear looks at
+static byte title_row;	// next 32-byte row of the title to stream
 static int iy,dy;
 
+#ifdef PROFILE
+byte prof_section;	// section currently running, see profile.h
+word prof_frame;	// main loop iterations since power-on
+#endif
+
+#ifdef TELEMETRY
+Telemetry telemetry;	// lag counters, see profile.h
+#endif
+
 
 // number of rows in scrolling playfield (without status bar)
 #define PLAYROWS 27
@@ -67,16 +146,90 @@ static int iy,dy;
 
 //#define PLAYER_MAX_VELOCITY -10 // Max speed of the player; we won't let you go past this.
 //#define PLAYER_VELOCITY_ACCEL 2 // How quickly do we get up to max velocity? 
-// buffers that hold vertical slices of nametable data
 #define FP_BITS 4
+
+// scroll speed in 1/(1<<FP_BITS) pixels per frame,
+// it ramps up by SCROLL_SPEED_RAMP with every point
+// (column updates keep up with at most 4 pixels per frame)
+#define SCROLL_SPEED_START (1<<FP_BITS)
+#define SCROLL_SPEED_MAX (3<<FP_BITS)
+#define SCROLL_SPEED_RAMP 1
 #define bird_color 0
 
-char ntbuf1[PLAYROWS];	// left side
-char ntbuf2[PLAYROWS];	// right side
+// first pipe tile in the pattern table
+#define PIPE_CHAR 0xDF
+
+// a pipe metatile spans 3 tiles (PIPE_CHAR..PIPE_CHAR+2);
+// even segment widths draw tiles 0/1 and odd widths 1/2,
+// so every pipe column is one of 3 tiles x 6 heights.
+// tile row r of a column with bottom height h is solid
+// above the opening (2*(7-h) rows) and in the 2*h rows
+// below it, leaving the last 3 rows empty
+#define PIPE_ROW(ch,h,r)\
+  (((r) < 14-2*(h) || ((r) >= 24-2*(h) && (r) < 24)) ? (ch) : 0)
+
+#define PIPE_COLUMN(ch,h) {\
+  PIPE_ROW(ch,h,0),  PIPE_ROW(ch,h,1),  PIPE_ROW(ch,h,2),\
+  PIPE_ROW(ch,h,3),  PIPE_ROW(ch,h,4),  PIPE_ROW(ch,h,5),\
+  PIPE_ROW(ch,h,6),  PIPE_ROW(ch,h,7),  PIPE_ROW(ch,h,8),\
+  PIPE_ROW(ch,h,9),  PIPE_ROW(ch,h,10), PIPE_ROW(ch,h,11),\
+  PIPE_ROW(ch,h,12), PIPE_ROW(ch,h,13), PIPE_ROW(ch,h,14),\
+  PIPE_ROW(ch,h,15), PIPE_ROW(ch,h,16), PIPE_ROW(ch,h,17),\
+  PIPE_ROW(ch,h,18), PIPE_ROW(ch,h,19), PIPE_ROW(ch,h,20),\
+  PIPE_ROW(ch,h,21), PIPE_ROW(ch,h,22), PIPE_ROW(ch,h,23),\
+  PIPE_ROW(ch,h,24), PIPE_ROW(ch,h,25), PIPE_ROW(ch,h,26) }
+
+#define PIPE_HEIGHTS(ch) {\
+  PIPE_COLUMN(ch,1), PIPE_COLUMN(ch,2), PIPE_COLUMN(ch,3),\
+  PIPE_COLUMN(ch,4), PIPE_COLUMN(ch,5), PIPE_COLUMN(ch,6) }
+
+// every pipe column, indexed by [tile][seg_height-1]
+// built by the compiler, so drawing a column is just a copy from ROM
+const char pipe_columns[3][6][PLAYROWS] = {
+  PIPE_HEIGHTS(PIPE_CHAR),
+  PIPE_HEIGHTS(PIPE_CHAR+1),
+  PIPE_HEIGHTS(PIPE_CHAR+2),
+};
+
+// an empty column between pipes
+const char blank_column[PLAYROWS] = { 0 };
+
+// vertical slices of nametable data, set by fill_buffer/fill_blank
+const char* ntcol1;	// left side
+const char* ntcol2;	// right side
+
+word coladdr;		// nametable address of ntcol1
+
+// solid metatile rows of the pipe column with bottom height h,
+// bit n is playfield metatile row n (matches PIPE_ROW)
+#define PIPE_MASK(h) (((1<<(7-(h)))-1) | (((1<<(h))-1) << (12-(h))))
+
+const word pipe_masks[6] = {
+  PIPE_MASK(1), PIPE_MASK(2), PIPE_MASK(3),
+  PIPE_MASK(4), PIPE_MASK(5), PIPE_MASK(6),
+};
+
+// solid rows of every metatile column in both nametables,
+// written by fill_buffer/fill_blank as each column is drawn
+word colmask[32];
+
+// first pipe tile of every metatile column (0 or 1 past PIPE_CHAR)
+byte coltile[32];
+
+// top of the playfield in pixels
+#define PLAYFIELD_Y 32
+byte colright;		// nonzero until ntcol2 has been queued
 
 // a vertical slice of attribute table entries
 char attrbuf[PLAYROWS/4];
 
+// RAM copy of both attribute tables (A at 0..63, B at 64..127)
+// only bytes that differ from it get sent to the PPU
+byte attrshadow[128];
+
+// index into attrshadow for an attribute table address
+#define ATTR_SHADOW_INDEX(a) ((((a) >> 4) & 0x40) | ((a) & 0x3f))
+
 #define DEF_METASPRITE_2x2(name,code,pal)\
 const unsigned char name[]={\
         0,      0,      (code),   bird_color, \
@@ -101,6 +254,39 @@ const unsigned char* const birdSeq[16] = {
   bird, birdFly,
 };
 
+#ifdef COMPILED_SPRITES
+const metaspr_fn birdSeqFn[16] = {
+  metaspr_bird, metaspr_birdFly, metaspr_birdFly2, 
+  metaspr_bird, metaspr_birdFly, metaspr_birdFly2, 
+  metaspr_bird, metaspr_birdFly,
+  metaspr_bird, metaspr_birdFly, metaspr_birdFly2, 
+  metaspr_bird, metaspr_birdFly, metaspr_birdFly2, 
+  metaspr_bird, metaspr_birdFly,
+};
+#endif
+
+// bird velocity curve, built by mkphysics.py
+#include "bird_physics.h"
+
+// lowest y the bird can fall to
+#define BIRD_FLOOR 212
+
+// per-row pixel masks of the bird frames and pipe tiles
+#include "collision_masks.h"
+
+// masks of the birdSeq frames
+const word* const birdSeqMask[16] = {
+  bird_mask, birdFly_mask, birdFly2_mask, 
+  bird_mask, birdFly_mask, birdFly2_mask, 
+  bird_mask, birdFly_mask,
+  bird_mask, birdFly_mask, birdFly2_mask, 
+  bird_mask, birdFly_mask, birdFly2_mask, 
+  bird_mask, birdFly_mask,
+};
+
+// mask of the bird frame drawn last
+const word* bird_cur_mask;
+
 const unsigned char CoinsSpr[]={
   0,  0,0x7b,3,
   8,  0,0x82,3,
@@ -111,13 +297,39 @@ const unsigned char CoinsSpr[]={
   128
 };
 
+// bird bounding box, relative to its sprite position
+// (bird_pixels_hit refines it)
+#define BIRD_HIT_LEFT	0
+#define BIRD_HIT_RIGHT	15
+#define BIRD_HIT_TOP	0
+#define BIRD_HIT_BOTTOM	15
+
+// actor types
+#define ACTOR_NONE	0	// free slot
+#define ACTOR_BIRD	1	// the player, always slot 0
+#define ACTOR_CLOUD	2
+#define ACTOR_BULLET	3
+
+// actor pool, slot 0 is the bird
+#define NUM_ACTORS 16
+#define NO_ACTOR 0xff
+
+// chance in 256 of an enemy with each new pipe segment
+#define ENEMY_CHANCE 96
+
 // sprite x/y positions
-#define NUM_ACTORS 1
 byte actor_x[NUM_ACTORS];
 byte actor_y[NUM_ACTORS];
 // actor x/y deltas per frame (signed)
 sbyte actor_dx[NUM_ACTORS];
 sbyte actor_dy[NUM_ACTORS];
+byte actor_type[NUM_ACTORS];
+// next free slot, for slots on the free list
+byte actor_next[NUM_ACTORS];
+// first free slot or NO_ACTOR
+byte actor_free;
+// live actors besides the bird
+byte actor_count;
 
 /*{pal:"nes",layout:"nes"}*/
 const char PALETTE[32] = { 
@@ -136,17 +348,6 @@ const char PALETTE[32] = {
 
 /// FUNCTIONS
 
-// generate new random segment
-void new_segment() {
-  last_seg_height=seg_height;
-  seg_height = (rand8() & 5)+1;
-  //seg_height =5;
-  seg_height2=(6-seg_height)+1;
-  seg_width=8;
-  seg_palette = 0;
-  seg_char = 0xDF;
-}
-
 // function to write a string into the name table
 //   adr = start address in name table
 //   str = pointer to string
@@ -157,85 +358,274 @@ void put_str(unsigned int adr, const char *str) {
 
 void draw_bcd_word(byte col, byte row, word bcd) {
   byte j;
-  static char buf[5];
-  buf[4] = CHAR('0');
+  // write digits straight into the update buffer
+  char* buf = vrambuf_reserve(NTADR_A(col, row), 3, VRAMBUF_PRI_HUD);
   for (j=2; j<0x80; j--) {
     buf[j] = CHAR('0'+(bcd&0xf));
     bcd >>= 4;
   }
-  vrambuf_put(NTADR_A(col, row), buf, 3);
+  vrambuf_end();
+}
+
+// digit i (0 = most significant) of a 6-digit packed BCD number
+#define BCD6_DIGIT(bcd,i) \
+  (((i)&1) ? (bcd)[2-(i)/2] & 15 : (bcd)[2-(i)/2] >> 4)
+
+// queue len digits of bcd starting at digit first
+void put_bcd_digits(word addr, const byte* bcd, byte first, byte len) {
+  char* p;
+  addr += first;
+  if (len == 1) {
+    // a single non-sequential write is a byte shorter
+    p = vrambuf_alloc(3, VRAMBUF_PRI_HUD);
+    p[0] = addr >> 8;
+    p[1] = addr;
+    p[2] = CHAR('0'+BCD6_DIGIT(bcd, first));
+  } else {
+    p = vrambuf_reserve(addr, len, VRAMBUF_PRI_HUD);
+    for (; len; --len, ++first)
+      *p++ = CHAR('0'+BCD6_DIGIT(bcd, first));
+  }
+  vrambuf_end();
+}
+
+// draw the digits of 6-digit packed BCD number bcd at addr
+// that differ from shown, one run per group of changed digits
+void draw_bcd6(word addr, const byte* bcd, byte* shown) {
+  byte i, run;
+  run = 0;
+  for (i=0; i<6; i++) {
+    if (BCD6_DIGIT(bcd, i) != BCD6_DIGIT(shown, i)) {
+      ++run;
+    } else if (run) {
+      put_bcd_digits(addr, bcd, i-run, run);
+      run = 0;
+    }
+  }
+  if (run)
+    put_bcd_digits(addr, bcd, 6-run, run);
+  memcpy(shown, bcd, 3);
+}
+
+// (the HUD task draws it)
+void add_score(byte bcd) {
+  bcd_add6(player_score, bcd);
+}
+
+// copy player_score to high_score if it's better
+// and draw it
+void update_high_score() {
+  byte i;
+  for (i=2; i<0x80; i--) {
+    if (player_score[i] != high_score[i]) {
+      if (player_score[i] > high_score[i])
+        memcpy(high_score, player_score, 3);
+      break;
+    }
+  }
+  draw_bcd6(NTADR_A(23,3), high_score, high_shown);
 }
 
-void add_score(word bcd) {
-  player_score = bcd_add(player_score, bcd);
-  draw_bcd_word(3, 3, player_score);
+#ifdef TELEMETRY
+// wait for the next NMI, counting a lag frame if the
+// NMI already fired since the previous wait returned
+void telemetry_wait_nmi() {
+  if (nesclock() != telemetry.last_clock) {
+    ++telemetry.lag_frames;
+#ifdef TELEMETRY_HUD
+    telemetry.lag_bcd = bcd_add(telemetry.lag_bcd, 1);
+    draw_bcd_word(26, 1, telemetry.lag_bcd);
+#endif
+  }
+  ++telemetry.frame_done;
+#ifdef TELEMETRY_TINT
+  ppu_mask(MASK_BG|MASK_SPR|MASK_EDGE_BG|MASK_EDGE_SPR|MASK_MONO);
+#endif
+  ppu_wait_nmi();
+#ifdef TELEMETRY_TINT
+  ppu_mask(MASK_BG|MASK_SPR|MASK_EDGE_BG|MASK_EDGE_SPR);
+#endif
+  telemetry.last_clock = nesclock();
 }
+// restart lag counting after a state's setup
+#define telemetry_sync() (telemetry.last_clock = nesclock())
+#else
+#define telemetry_wait_nmi ppu_wait_nmi
+#define telemetry_sync()
+#endif
 
 // returns absolute value of x
 byte iabs(int x) {
   return x >= 0 ? x : -x;
 }
 
+// empty the actor pool, except for the bird in slot 0
+void init_actors() {
+  for (i=1; i<NUM_ACTORS; i++) {
+    actor_type[i] = ACTOR_NONE;
+    actor_next[i] = i+1;
+  }
+  actor_next[NUM_ACTORS-1] = NO_ACTOR;
+  actor_free = 1;
+  actor_count = 0;
+  actor_type[0] = ACTOR_BIRD;
+}
+
+// take a slot off the free list, returns NO_ACTOR if full
+byte spawn_actor(byte type, byte x, byte y, sbyte dx, sbyte dy) {
+  byte a = actor_free;
+  if (a != NO_ACTOR) {
+    actor_free = actor_next[a];
+    ++actor_count;
+    actor_type[a] = type;
+    actor_x[a] = x;
+    actor_y[a] = y;
+    actor_dx[a] = dx;
+    actor_dy[a] = dy;
+  }
+  return a;
+}
+
+// put a slot back on the free list
+void despawn_actor(byte a) {
+  actor_type[a] = ACTOR_NONE;
+  actor_next[a] = actor_free;
+  actor_free = a;
+  --actor_count;
+}
+
+// send a cloud or a Bullet Bill in from the right edge
+void spawn_enemy() {
+  if (rand8() & 1)
+    spawn_actor(ACTOR_CLOUD, 240, 40 + (rand8() & 31), 0, 0);
+  else
+    spawn_actor(ACTOR_BULLET, 240, 48 + (rand8() & 127), -1, 0);
+}
+
+// generate new random segment
+void new_segment() {
+  seg_height = (rand8() & 5)+1;
+  //seg_height =5;
+  seg_height2=(6-seg_height)+1;
+  seg_width=8;
+  seg_palette = 0;
+  seg_char = PIPE_CHAR;
+  // now and then an enemy comes with it
+  if (rand8() < ENEMY_CHANCE)
+    spawn_enemy();
+}
+
+// enemies scroll with the playfield on top of their own motion,
+// and go away once they leave the screen
+// (all of actor_scroll, in case update_actors waited a frame)
+void update_enemy(byte a) {
+  int x = actor_x[a] - actor_scroll + actor_dx[a];
+  if (x < 0 || x > 255) {
+    despawn_actor(a);
+    return;
+  }
+  actor_x[a] = x;
+  actor_y[a] += actor_dy[a];
+}
+
+// per-type update handlers, indexed by actor_type
+// (the bird is moved by move_player)
+void (* const actor_update[])(byte) = {
+  NULL,		// ACTOR_NONE
+  NULL,		// ACTOR_BIRD
+  update_enemy,	// ACTOR_CLOUD
+  update_enemy,	// ACTOR_BULLET
+};
+
+// metasprite for each actor type
+const unsigned char* const actor_sprite[] = {
+  NULL,		// ACTOR_NONE
+  NULL,		// ACTOR_BIRD, see birdSeq
+  enemyCloud,	// ACTOR_CLOUD
+  bulletBill,	// ACTOR_BULLET
+};
+
+#ifdef COMPILED_SPRITES
+const metaspr_fn actor_sprite_fn[] = {
+  NULL,			// ACTOR_NONE
+  NULL,			// ACTOR_BIRD, see birdSeqFn
+  metaspr_enemyCloud,	// ACTOR_CLOUD
+  metaspr_bulletBill,	// ACTOR_BULLET
+};
+
+// hardware sprites in each of them
+const byte actor_sprite_len[] = {
+  0,				// ACTOR_NONE
+  0,				// ACTOR_BIRD
+  METASPR_LEN_enemyCloud,	// ACTOR_CLOUD
+  METASPR_LEN_bulletBill,	// ACTOR_BULLET
+};
+#endif
+
+// run the update handler of every actor but the bird
+void update_actors() {
+  byte a;
+  for (a=1; a<NUM_ACTORS; a++) {
+    if (actor_type[a] != ACTOR_NONE)
+      actor_update[actor_type[a]](a);
+  }
+  actor_scroll = 0;
+}
+
+// move the bird along its velocity curve, one table
+// lookup and one 16-bit add per frame
+void move_bird() {
+  word y = ((word)actor_y[0] << 8 | bird_yfrac) + fall_v[bird_t];
+  if (bird_t < FALL_FRAMES)
+    ++bird_t;
+  // stop at the top of the screen and the floor
+  if (y < (8<<8)) {
+    y = 8<<8;
+    bird_t = FALL_T_REST;
+  } else if (y > (BIRD_FLOOR<<8)) {
+    y = BIRD_FLOOR<<8;
+  }
+  actor_y[0] = y >> 8;
+  bird_yfrac = y;
+  // whole pixels, for picking the animation frame
+  actor_dy[0] = fall_v[bird_t] >> 8;
+}
+
 void reset_players() {
     actor_x[0] = 80;
     actor_y[0] = 80;
     actor_dx[0] = 0;
     actor_dy[0] = 1;
+    bird_t = FALL_T_REST;
+    bird_yfrac = 0;
+    bird_cur_mask = bird_mask;
   
 }
 
 void clrscr() {
-  vrambuf_clear();
+  vrambuf_reset();
+#ifdef COLUMN_BLIT
+  colblit_pending = 0;
+#endif
   ppu_off();
   vram_adr(0x2000);
   vram_fill(8, 32*28);
   vram_adr(0x24c0);
+  // clear both attribute tables to match the shadow copy
+  vram_adr(0x23c0);
+  vram_fill(0, 64);
+  vram_adr(0x27c0);
+  vram_fill(0, 64);
+  memset(attrshadow, 0, sizeof(attrshadow));
   ppu_on_bg();
 }
 
-void pal_fade_to(unsigned to)
-{
- if(!to) music_stop();
-
-  while(bright!=to)
-  {
-    delay(4);
-    if(bright<to) ++bright; else --bright;
-    pal_bright(bright);
-  }
-
-  if(!bright)
-  {
-    ppu_off();
-    set_vram_update(NULL);
-    scroll(0,0);
-  }
-}
-
 // convert from nametable address to attribute table address
 word nt2attraddr(word a) {
   return (a & 0x2c00) | 0x3c0 |
     ((a >> 4) & 0x38) | ((a >> 2) & 0x07);
 }
 
-// draw metatile into nametable buffers
-// y is the metatile coordinate (row * 2)
-// ch is the starting tile index in the pattern table
-void set_metatile(byte y, byte ch) {
-  if (seg_width%2==0){
-  ntbuf1[y*2] = ch;
-  ntbuf1[y*2+1] = ch;
-  ntbuf2[y*2] = ch+1;
-  ntbuf2[y*2+1] = ch+1;
-  }
-  else{
-  ntbuf1[y*2] = ch+1;
-  ntbuf1[y*2+1] = ch+1;
-  ntbuf2[y*2] = ch+2;
-  ntbuf2[y*2+1] = ch+2;
-  }
-}
-
 // set attribute table entry in attrbuf
 // x and y are metatile coordinates
 // pal is the index to set
@@ -245,54 +635,108 @@ void set_attr_entry(byte x, byte y, byte pal) {
   attrbuf[y/2] |= pal;
 }
 
-// fill ntbuf with tile data
+// point ntcol1/ntcol2 at the ROM columns for this pipe slice
 // x = metatile coordinate
 void fill_buffer(byte x) {
-  byte i,y,j;
-  // clear nametable buffers
-  memset(ntbuf1, 0, sizeof(ntbuf1));
-  memset(ntbuf2, 0, sizeof(ntbuf2));
-  // draw a random star
- // ntbuf1[rand8() & 15] = '.';
-  // draw segment slice to both nametable buffers
-  for (i=0; i<seg_height; i++) {
-    y = PLAYROWS/2-2-i;
-    set_metatile(y, seg_char);
-    set_attr_entry(x, y, seg_palette);
-    }
-  for (i=0; i<seg_height2; i++){
-    j = PLAYROWS/2-13+i;
-    set_metatile(j, seg_char);
-    set_attr_entry(x, j, seg_palette);
+  byte i;
+  // odd segment widths use the next pair of tiles
+  byte t = (seg_char - PIPE_CHAR) + (seg_width & 1);
+  ntcol1 = pipe_columns[t][seg_height-1];
+  ntcol2 = pipe_columns[t+1][seg_height-1];
+  colmask[x] = pipe_masks[seg_height-1];
+  coltile[x] = t;
+  // load_attr_column already set this column to palette 0
+  if (seg_palette) {
+    for (i=0; i<seg_height; i++)
+      set_attr_entry(x, PLAYROWS/2-2-i, seg_palette);
+    for (i=0; i<seg_height2; i++)
+      set_attr_entry(x, i, seg_palette);
   }
-  
 }
+
 void fill_blank(byte x) {
-  //byte i,y;
-  // clear nametable buffers
-  memset(ntbuf1, 0, sizeof(ntbuf1));
-  memset(ntbuf2, 0, sizeof(ntbuf2));
-  // draw a random star
-  //ntbuf1[rand8() & 15] = '.';
-  // draw segment slice to both nametable buffers
- /* for (i=0; i<seg_height; i++) {
-    y = PLAYROWS/2-1-i;
-    set_metatile(y, seg_char);
-    set_attr_entry(x, y, seg_palette);
-  }*/
-  x=x;
-}
-
-// write attribute table buffer to vram buffer
+  ntcol1 = blank_column;
+  ntcol2 = blank_column;
+  colmask[x] = 0;
+}
+
+// fill attrbuf from the shadow copy at addr, with the
+// entries for metatile column x cleared to palette 0
+void load_attr_column(word addr, byte x) {
+  byte i;
+  byte* shadow = attrshadow + ATTR_SHADOW_INDEX(addr);
+  // keep the other metatile column's half of each byte
+  byte keep = (x&1) ? 0x33 : 0xcc;
+  for (i=0; i<PLAYROWS/4; i++) {
+    attrbuf[i] = *shadow & keep;
+    shadow += 8;
+  }
+}
+
+// write changed attribute table buffer entries to vram buffer
+// and the shadow copy
 void put_attr_entries(word addr) {
   byte i;
+  char* p;
+  byte* shadow = attrshadow + ATTR_SHADOW_INDEX(addr);
   for (i=0; i<PLAYROWS/4; i++) {
-    VRAMBUF_PUT(addr, attrbuf[i], 0);
+    if (*shadow != attrbuf[i]) {
+      *shadow = attrbuf[i];
+      // one non-sequential write per attribute byte
+      p = vrambuf_alloc(3, VRAMBUF_PRI_SCROLL);
+      p[0] = addr >> 8;
+      p[1] = addr;
+      p[2] = attrbuf[i];
+    }
+    shadow += 8;
     addr += 8;
   }
   vrambuf_end();
 }
 
+// queue ntcol1/ntcol2 and attrbuf for upload at addr
+void put_columns(word addr) {
+#ifdef COLUMN_BLIT
+  byte i;
+  byte* shadow;
+  // hand the columns straight to the NMI, unless it
+  // hasn't uploaded the last pair yet (lag frame)
+  if (!colblit_pending) {
+    colblit_col1 = ntcol1;
+    colblit_col2 = ntcol2;
+    colblit_addr = addr;
+    colblit_attraddr = nt2attraddr(addr);
+    memcpy(colblit_attr, attrbuf, sizeof(attrbuf));
+    // the blitter always sends all of them
+    shadow = attrshadow + ATTR_SHADOW_INDEX(colblit_attraddr);
+    for (i=0; i<PLAYROWS/4; i++) {
+      *shadow = attrbuf[i];
+      shadow += 8;
+    }
+    colblit_pending = 1;
+    return;
+  }
+#endif
+  // draw vertical slice from ROM columns to name table
+  // starting with leftmost slice, which scrolls in next frame
+  vrambuf_put(addr | VRAMBUF_VERT, ntcol1, PLAYROWS);
+  // compute attribute table address
+  // then set attribute table entries
+  put_attr_entries(nt2attraddr(addr));
+  // the rightmost slice isn't visible for another 8 frames,
+  // so put_right_column queues it later to spread the load
+  coladdr = addr;
+  colright = 1;
+}
+
+// queue the rightmost slice left over by put_columns
+void put_right_column() {
+  if (colright) {
+    vrambuf_put((coladdr+1) | VRAMBUF_VERT, ntcol2, PLAYROWS);
+    colright = 0;
+  }
+}
+
 // update the nametable offscreen
 // called every 8 horizontal pixels
 void update_offscreen() {
@@ -303,7 +747,14 @@ void update_offscreen() {
   // divide x_scroll by 8
   // to get nametable X position
   x = (x_scroll/8 + 32) & 63;
-  // fill the ntbuf arrays with tiles
+  // get address in either nametable A or B
+  if (x < 32)
+    addr = NTADR_A(x, 4);
+  else
+    addr = NTADR_B(x&31, 4);
+  // start from the attributes already on screen
+  load_attr_column(nt2attraddr(addr), x/2);
+  // pick the columns of tiles to draw
 if(seg_width>=7)
   fill_buffer(x/2);
 
@@ -312,24 +763,8 @@ if(seg_width>=7)
  else if(seg_width<8)
    fill_blank(x/2);
   
-  // get address in either nametable A or B
-  if (x < 32)
-    addr = NTADR_A(x, 4);
-  else
-    addr = NTADR_B(x&31, 4);
-  // draw vertical slice from ntbuf arrays to name table
-  // starting with leftmost slice
-  vrambuf_put(addr | VRAMBUF_VERT, ntbuf1, PLAYROWS);
-  // then the rightmost slice
-  vrambuf_put((addr+1) | VRAMBUF_VERT, ntbuf2, PLAYROWS);
-  // compute attribute table address
-  // then set attribute table entries
-  // we update these twice to prevent right-side artifacts
-  put_attr_entries(nt2attraddr(addr));
-  // every 4 columns, clear attribute table buffer
-  if ((x & 4) == 2) {
-    memset(attrbuf, 0, sizeof(attrbuf));
-  }
+  // draw vertical slices and attributes to name table
+  put_columns(addr);
   // decrement segment width, create new segment when it hits zero
   if (--seg_width == 0) {
     new_segment();
@@ -337,37 +772,84 @@ if(seg_width>=7)
   }
 }
 
+// metatile row of a sprite y coordinate
+// (anything above the playfield counts as row 0)
+byte pixel_row(byte y) {
+  // sprites are displayed one line below their y
+  ++y;
+  return y < PLAYFIELD_Y ? 0 : (y - PLAYFIELD_Y) >> 4;
+}
+
+// does the bird's hitbox overlap a solid metatile?
+// two column lookups, however many pipes are on screen
+bool bird_hits_pipe() {
+  word rows;
+  word x = x_scroll + actor_x[0];
+  // mask of the metatile rows the hitbox spans
+  rows = (2 << pixel_row(actor_y[0]+BIRD_HIT_BOTTOM))
+       - (1 << pixel_row(actor_y[0]+BIRD_HIT_TOP));
+  return ((colmask[((x+BIRD_HIT_LEFT) >> 4) & 31] |
+           colmask[((x+BIRD_HIT_RIGHT) >> 4) & 31]) & rows) != 0;
+}
+
+// pixels of the pipe tile at tile column tx, playfield pixel row py
+byte pipe_bits(byte tx, byte py) {
+  byte mx = (tx >> 1) & 31;
+  if (!(colmask[mx] & (1 << (py >> 4))))
+    return 0;
+  return pipe_tile_mask[coltile[mx] + (tx & 1)][py & 7];
+}
+
+// test the bird's pixels against the pipe tiles under it,
+// only called when bird_hits_pipe found an overlap
+bool bird_pixels_hit() {
+  byte r, tx, shift, y, py;
+  word row;
+  word x = x_scroll + actor_x[0];
+  tx = x >> 3;
+  shift = x & 7;
+  // sprites are displayed one line below their y
+  y = actor_y[0] + 1;
+  for (r=0; r<16; r++, y++) {
+    // pipes extend up into the status bar
+    py = y < PLAYFIELD_Y ? 0 : y - PLAYFIELD_Y;
+    // 16 pipe pixels lined up with the bird's row
+    row = (pipe_bits(tx, py) << 8 | pipe_bits(tx+1, py)) << shift;
+    if (shift)
+      row |= pipe_bits(tx+2, py) >> (8 - shift);
+    if (row & bird_cur_mask[r])
+      return true;
+  }
+  return false;
+}
+
 void update()
 {
 
-   low=209-(last_seg_height*16);
-   high=low-74;
-  
-   if(x_scroll>160)
-    {
-     if ((x_pos>3&&x_pos<10) && (actor_y[0]<high || actor_y[0]>low+4))
+     if (bird_hits_pipe() && bird_pixels_hit())
       {
        //reset_players();
        sfx_play(1,0);
-       pal_fade_to(8);
+       fade_to(8, FADE_RATE);
         gameover=1;
        //sfx_play(3,0);
       }
-    } 
    if (actor_y[0]>210)
    {
      sfx_play(1,0);
-     pal_fade_to(8);
+     fade_to(8, FADE_RATE);
   //reset_players();
      gameover=1;
      //sfx_play(32,0);
    }
-  pal_fade_to(4);
+  // once a flash has peaked, fade back to normal
+  if (fade_done())
+    fade_to(4, FADE_RATE);
   
 }
 
 void draw_sprite(){
-  // draw and move all actors
+  // draw all actors
   //if (actor_dy[0]>0){
    // direction=1;
 //  }
@@ -378,53 +860,63 @@ void draw_sprite(){
   //  direction=0;
  // }
           
-      for (i=0; i<NUM_ACTORS; i++) {
+  spr_begin();
+      for (i=0; i<1; i++) {
       byte runseq = actor_y[i] & 7;
       if (actor_dy[i] >= 0)
         runseq += 8;
-      if (direction==1)
-      oam_id = oam_meta_spr(actor_x[i], actor_y[i], oam_id, bird_down);
-      oam_id = oam_meta_spr(actor_x[i], actor_y[i], oam_id, birdSeq[runseq]);
-      actor_x[i] += actor_dx[i];
-      actor_y[i] += actor_dy[i]; 
+      if (direction==1) {
+#ifdef COMPILED_SPRITES
+        spr_request_fn(actor_x[i], actor_y[i], metaspr_bird_down,
+                       METASPR_LEN_bird_down, SPR_PRI_PLAYER);
+#else
+        spr_request(actor_x[i], actor_y[i], bird_down, SPR_PRI_PLAYER);
+#endif
+        bird_cur_mask = bird_down_mask;
+      } else {
+#ifdef COMPILED_SPRITES
+        spr_request_fn(actor_x[i], actor_y[i], birdSeqFn[runseq],
+                       METASPR_LEN_bird, SPR_PRI_PLAYER);
+#else
+        spr_request(actor_x[i], actor_y[i], birdSeq[runseq], SPR_PRI_PLAYER);
+#endif
+        bird_cur_mask = birdSeqMask[runseq];
+      }
       }
   
   
+  // the rest of the actors take turns if OAM runs out
+  for (i=1; i<NUM_ACTORS; i++) {
+    if (actor_type[i] != ACTOR_NONE)
+#ifdef COMPILED_SPRITES
+      spr_request_fn(actor_x[i], actor_y[i],
+                     actor_sprite_fn[actor_type[i]],
+                     actor_sprite_len[actor_type[i]],
+                     SPR_PRI_ACTOR);
+#else
+      spr_request(actor_x[i], actor_y[i],
+                  actor_sprite[actor_type[i]], SPR_PRI_ACTOR);
+#endif
+  }
+  
   	// draw "coins" at the top in sprites
-	oam_id = oam_meta_spr(24,8,oam_id, CoinsSpr);
+#ifdef COMPILED_SPRITES
+	spr_request_fn(24,8, metaspr_CoinsSpr, METASPR_LEN_CoinsSpr,
+                       SPR_PRI_HUD);
+#else
+	spr_request(24,8, CoinsSpr, SPR_PRI_HUD);
+#endif
 	//temp1 = coins + 0xf0;
 	//oam_id = oam_spr(64,16,temp1,3,oam_id);
+  oam_id = spr_end();
 }
 
-void loser_screen()
-{
-  direction=1;
-  while (1)
-  {
-    oam_id=4;
-      if (actor_y[0]<211)
-      {
-      actor_dy[0]=2;
-      actor_y[0] += actor_dy[0];
-      draw_sprite();
-      ppu_wait_nmi();
-      vrambuf_clear();
-      // split at sprite zero and set X scroll
-     // split(x_scroll, 0);
-      }
-
-    {
-
-      ppu_wait_frame();
-      if(pad_trigger(0)&PAD_START) break;
-
-    }
-  }
+// move the bird after drawing it
+void move_player() {
+  actor_x[0] += actor_dx[0];
+  move_bird();
 }
 
-
-
-
 void read_controller()
 {
    last_controller_state=pad;
@@ -432,156 +924,395 @@ void read_controller()
     for (i=0; i<1; i++) 
     {
       // poll controller i (0-1)
-      pad = pad_poll(0);
-      // move actor[i] up/down
-      if (pad&PAD_UP && actor_y[i]>8) {
-        actor_dy[0]=-7;
+      pad = replay_pad_poll();
+      // flap when up is pressed, restarting the velocity curve
+      if (pad&PAD_UP && !(last_controller_state&PAD_UP) && actor_y[i]>8) {
+        bird_t=0;
        // sfx_play(3,0);
         }
-      else if (pad&PAD_DOWN && actor_y[i]<212) actor_dy[i]=1;
-      else if (actor_y[i]>211){
-        actor_dy[0]=0;
-      }
-      else{
-        actor_dy[0]=2;}
+      // down cuts a flap short
+      else if (pad&PAD_DOWN && bird_t<FALL_T_REST) bird_t=FALL_T_REST;
     }
 
 }
 
 void check_score(){
-        if ((x_scroll & 7) == 0)
+  word x;
+  byte n;
+  // test every pixel position scrolled past this frame
+  for (x=x_scroll-scroll_px, n=scroll_px; n; ++x, --n)
+  {
+        if ((x & 7) == 0)
       {
-        if(x_scroll>160)
+        if(x>160)
          {     
           
-         if (x_pos==8)
+         if ((((x+3)/8 + 32) & 15)==8)
          {
          sfx_play(0,0);
          add_score(1);
+         if (scroll_speed < SCROLL_SPEED_MAX)
+           scroll_speed += SCROLL_SPEED_RAMP;
          }
          
          } 
       }
+  }
 }
   
 
-// scrolls the screen left one pixel
+// scrolls the screen left scroll_px pixels
 void scroll_left() {
-  // update nametable every 16 pixels
-  if ((x_scroll & 15) == 0) {
-    update_offscreen();
+  byte n;
+  // step one pixel at a time so no column boundary is skipped
+  for (n=scroll_px; n; --n) {
+    // update nametable every 16 pixels,
+    // the right half of the metatile column 4 pixels later
+    if ((x_scroll & 15) == 0) {
+      update_offscreen();
+    } else if ((x_scroll & 15) == 4) {
+      put_right_column();
+    }
+    // increment x_scroll
+    ++x_scroll;
   }
-  // increment x_scroll
-  ++x_scroll;
 }
 
-// main loop, scrolls left continuously
-void scroll_demo() {
-  // get data for initial segment
-  new_segment();
-  last_seg_height=seg_height;
- // draw_bcd_word(4,2,CHAR("Hello"));
-  //infinite loop
-  while (1) 
-  {
-    oam_id = 4;
-    read_controller(); 
-    draw_sprite();
+// reset everything a round changes, except the screen
+void reset_round() {
+  memset(player_score, 0, sizeof(player_score));
+  gameover=0;
+  x_scroll=0;
+  scroll_speed=SCROLL_SPEED_START;
+  scroll_frac=0;
+  scroll_px=0;
+  actor_scroll=0;
+  colright=0;
+  play_frames=0;
+  direction=0;
+  init_actors();
+  reset_players();
+}
 
-    x_pos = ((x_scroll+3)/8 + 32) & 15;
-    x_exact_pos = ((x_scroll+3)/8 + 32) & 255;
-    
-    //updates score and collisions every 2 pixels
-    //if ((x_scroll & 7) == 0)
-    update();
-    
-    if(gameover==1)
-      break;
+// clear the screen and set up the status bar for the first round
+void new_screen() {
+  clrscr();
 
-    check_score();
-       
-    // ensure VRAM buffer is cleared
-    ppu_wait_nmi();
-    vrambuf_clear();
- 
-    // split at sprite zero and set X scroll
-    split(x_scroll, 0);
-               
-    // scroll to the left
-    scroll_left();
-    if(gameover==1)
-      break;
-  }
+  // the screen was cleared, so every digit needs drawing
+  memset(score_shown, 0xff, sizeof(score_shown));
+  memset(high_shown, 0xff, sizeof(high_shown));
+  memset(colmask, 0, sizeof(colmask));
+  reset_round();
+  // set sprite 0
+  oam_clear();
   
- loser_screen();
-
+  //sets sprite 0 to declare split line
+  oam_spr(0, 29, 0xa0, 0x20, 0); 
+  //put_str(NTADR_A(2,2), "Birdie");
+  
+  // set attributes
+  set_vram_update(updbuf);
+#ifdef COLUMN_BLIT
+  // the column blitter resets the status bar scroll to 0,0
+  scroll(0,0);
+#endif
+  update_high_score();
+  // enable PPU rendering (turn on screen)
+  ppu_on_all();
 }
 
+// game states, sched_run runs one frame of tasks at a time
+extern const SchedState title_state;
+extern const SchedState start_state;
+extern const SchedState play_state;
+extern const SchedState over_state;
+extern const SchedState retry_state;
 
-
-void title_screen(void)
-{
-  byte i;
+// title screen, drops in and bounces until START
+void title_enter() {
   scroll(0,240);//title is aligned to the color attributes, so shift it a bit to the right
 
-  vram_adr(NTADR_A(0,0));
-  
-  vram_unrle(flappyBird_titlescreen);
+#ifdef TITLE_STREAM
+  // title_stream fills it in while the title drops
+  vrambuf_reset();
+  set_vram_update(updbuf);
+  lz4s_begin(title_lz4);
+  title_row = 0;
+#else
+  vram_unlz4(title_lz4, (unsigned char*)NTADR_A(0,0), TITLE_SIZE);
+  title_row = TITLE_SIZE/32;
+#endif
 
  
  //vram_adr(NAMETABLE_C);//clear second nametable, as it is visible in the jumping effect
   //vram_fill(40,1024);
 
   pal_bg(PALETTE);
-  pal_bright(4);
+  fade_set(4);
   ppu_on_bg();
-  delay(20);//delay just to make it look better
 
   iy=240<<FP_BITS;
   dy=-8<<FP_BITS;
   frame_cnt=0;
+#ifdef TITLE_STREAM
   wait=0;
-  bright=4;
-  
-  while(1)
-  {
-    ppu_wait_frame();
-    scroll(0,iy>>FP_BITS);
-    if(pad_trigger(0)&PAD_START) break;
-    iy+=dy;
-    if(iy<0)
-    {
-      iy=0;
-      dy=-dy>>1;
-    }
-    if(dy>(-8<<FP_BITS)) dy-=2;
-    if(wait)
-    {
-      --wait;
-    }
-    else
-    {
-      pal_col(2,(frame_cnt&32)?0x1a:0x39);//blinking press start text
-      ++frame_cnt;
-    }
+#else
+  wait=20;//hold still a moment just to make it look better
+#endif
+  telemetry_sync();
+}
+
+// queue the next rows of the title, including its attributes
+void title_stream() {
+  byte n;
+  for (n=0; n<TITLE_ROWS_PER_FRAME && title_row<TITLE_SIZE/32; n++) {
+    lz4s_read(vrambuf_reserve(NTADR_A(0,title_row), 32, VRAMBUF_PRI_SCROLL), 32);
+    vrambuf_end();
+    ++title_row;
   }
+}
 
-  scroll(1,0);//if start is pressed, show the title at whole
-  sfx_play(0,0);//titlescreen sound effect
-  for(i=0;i<16;++i)//and blink the text faster
+void title_frame() {
+  if(wait)
+  {
+    --wait;
+    return;
+  }
+  scroll(0,iy>>FP_BITS);
+  if(replay_pad_trigger()&PAD_START)
+  {
+    scroll(1,0);//if start is pressed, show the title at whole
+    sfx_play(0,0);//titlescreen sound effect
+    wait=64;
+    sched_goto(&start_state);
+    return;
+  }
+  iy+=dy;
+  if(iy<0)
   {
-    pal_col(2,i&1?0x1a:0x39);
-    delay(4);
+    iy=0;
+    dy=-dy>>1;
   }
-  pal_fade_to(4);
-  vrambuf_clear();
+  if(dy>(-8<<FP_BITS)) dy-=2;
+  // a palette update on top of title rows would overrun vblank
+  if(title_row==TITLE_SIZE/32)
+    pal_col(2,(frame_cnt&32)?0x1a:0x39);//blinking press start text
+  ++frame_cnt;
+}
+
+// START was pressed, blink the text faster then play
+void start_frame() {
+  --wait;
+  if(title_row==TITLE_SIZE/32)
+    pal_col(2,wait&4?0x39:0x1a);
+  if(wait)
+    return;
+  // seed the pipe generator from the time spent on the title screen,
+  // unless a headless runner already poked rng_seed
+  // (neslib's generator needs both seed bytes nonzero)
+  if (!rng_seed)
+    rng_seed = ((word)nesclock() << 8) | frame_cnt | 0x0101;
+  // when recording or playing back input, the run starts here
+  rng_seed = replay_begin(rng_seed);
+  set_rand(rng_seed);
   ppu_off();
   vram_adr(NTADR_A(0,0));
   vram_fill(0, 32*32);
-  vrambuf_flush();
-  set_vram_update(updbuf);
+  new_screen();
+  sched_goto(&play_state);
+}
+
+// a round, scrolls left continuously
+void play_enter() {
+  // get data for initial segment
+  new_segment();
+#ifdef MMC3_SPLIT
+  mmc3_split_set(x_scroll);
+  mmc3_split_on = 1;
+#endif
+  telemetry_sync();
+}
+
+void play_split() {
+  // split at sprite zero and set X scroll
+  split(x_scroll, 0);
+}
+
+void play_scroll() {
+  ++play_frames;
+  // pixels to scroll this frame
+  scroll_frac += scroll_speed;
+  scroll_px = scroll_frac >> FP_BITS;
+  scroll_frac &= (1<<FP_BITS)-1;
+  actor_scroll += scroll_px;
+  scroll_left();
+#ifdef MMC3_SPLIT
+  // the IRQ shows it next frame, along with this frame's
+  // sprites and columns
+  mmc3_split_set(x_scroll);
+#endif
+}
+
+void play_sprites() {
+  draw_sprite();
+  move_player();
+}
+
+void play_update() {
+  x_exact_pos = ((x_scroll+3)/8 + 32) & 255;
+  update();
+  if(gameover==1)
+    sched_goto(&over_state);
+}
+
+void play_hud() {
+  draw_bcd6(NTADR_A(3,3), player_score, score_shown);
+}
+
+// game over, the bird drops to the floor until START
+void over_enter() {
+#ifdef MMC3_SPLIT
+  // game over shows the whole screen at the top scroll
+  mmc3_split_on = 0;
+#endif
+  update_high_score();
+  direction=1;
+}
+
+void over_fall() {
+  // the death flash fades back while the bird falls
+  if (fade_done())
+    fade_to(4, FADE_RATE);
+  // a steady 2 pixels a frame, not the flap physics
+  if (actor_y[0]<211)
+  {
+    actor_dy[0]=2;
+    actor_y[0] += actor_dy[0];
+    draw_sprite();
+  }
+}
+
+void over_input() {
+  if(replay_pad_trigger()&PAD_START)
+    sched_goto(&retry_state);
+}
+
+// START on game over starts over with rendering on,
+// game over shows nametable A at scroll 0, which is also
+// where a round starts, so only its pipes need blanking
+void retry_enter() {
+  reset_round();
+  // nametable B is redrawn before it scrolls into view
+  memset(colmask+16, 0, 16*sizeof(word));
+  retry_col = 0;
+  sfx_play(0,0);//get ready
 }
 
+// blank one metatile column with a pipe in it per frame,
+// the round starts once there are none left
+void retry_clear() {
+  word addr;
+  while (retry_col < 16 && !colmask[retry_col])
+    ++retry_col;
+  if (retry_col == 16) {
+    sched_goto(&play_state);
+    return;
+  }
+  addr = NTADR_A(retry_col*2, 4);
+  load_attr_column(nt2attraddr(addr), retry_col);
+  fill_blank(retry_col);
+  put_columns(addr);
+  put_right_column();
+  ++retry_col;
+}
+
+// estimated CPU cycles of the work that changes from frame
+// to frame, a PROFILE build under an emulator checks them
+#define COLUMN_CYCLES		2500	// update_offscreen, a new column
+#define RIGHT_COLUMN_CYCLES	800	// put_right_column
+#define SPRITE_CYCLES		800	// draw_sprite, per enemy
+#define ACTOR_CYCLES		400	// update_actors, per enemy
+#define HUD_CYCLES		1000	// draw_bcd6 with digits to put
+
+// the column work play_scroll will do this frame
+word scroll_cycles() {
+  word x = x_scroll;
+  byte n = (scroll_frac + scroll_speed) >> FP_BITS;
+  word cycles = 0;
+  for (; n; --n, ++x) {
+    if ((x & 15) == 0)
+      cycles += COLUMN_CYCLES;
+    else if ((x & 15) == 4)
+      cycles += RIGHT_COLUMN_CYCLES;
+  }
+  return cycles;
+}
+
+word sprite_cycles() {
+  return actor_count * SPRITE_CYCLES;
+}
+
+word actor_cycles() {
+  return actor_count * ACTOR_CYCLES;
+}
+
+// nothing to put unless the score changed
+word hud_cycles() {
+  return memcmp(player_score, score_shown, 3) ? HUD_CYCLES : 0;
+}
+
+const Task title_tasks[] = {
+#ifdef TITLE_STREAM
+  { title_stream,	10000,	0,		PROF_SCROLL },
+#endif
+  { title_frame,	1000,	0,		PROF_UPDATE },
+  { NULL }
+};
+
+// (START may come before the title has finished streaming)
+const Task start_tasks[] = {
+#ifdef TITLE_STREAM
+  { title_stream,	10000,	0,		PROF_SCROLL },
+#endif
+  { start_frame,	200,	0,		PROF_UPDATE },
+  { NULL }
+};
+
+// in frame order: input is read and the split waited for
+// before anything that can run long
+const Task play_tasks[] = {
+  { read_controller,	600,	0,		PROF_INPUT },
+#ifndef MMC3_SPLIT
+  { play_split,		3500,	0,		PROF_SPLIT },
+#endif
+  { play_scroll,	300,	0,		PROF_SCROLL,	scroll_cycles },
+  { play_sprites,	2000,	0,		PROF_SPRITES,	sprite_cycles },
+  { update_actors,	200,	TASK_DEFER,	PROF_ACTORS,	actor_cycles },
+  { play_update,	2500,	0,		PROF_UPDATE },
+  { check_score,	500,	0,		PROF_SCORE },
+  { play_hud,		200,	TASK_DEFER,	PROF_SCORE,	hud_cycles },
+  { NULL }
+};
+
+const Task over_tasks[] = {
+  { over_fall,		2000,	0,		PROF_SPRITES,	sprite_cycles },
+  { over_input,		600,	0,		PROF_INPUT },
+  { NULL }
+};
+
+const Task retry_tasks[] = {
+  { retry_clear,	2000,	0,		PROF_SCROLL },
+  { draw_sprite,	1500,	0,		PROF_SPRITES,	sprite_cycles },
+  { play_hud,		200,	0,		PROF_SCORE,	hud_cycles },
+  { NULL }
+};
+
+const SchedState title_state = { title_enter, title_tasks };
+const SchedState start_state = { NULL, start_tasks };
+const SchedState play_state = { play_enter, play_tasks };
+const SchedState over_state = { over_enter, over_tasks };
+const SchedState retry_state = { retry_enter, retry_tasks };
+
 // main function, run after console reset
 void main(void) {
 
@@ -590,41 +1321,23 @@ void main(void) {
   famitone_init(after_the_rain_music_data);
   sfx_init(demo_sounds);
   // set music callback function for NMI
-  nmi_set_callback(famitone_update);
+  // (fades step first, then column uploads, then music)
+#ifdef COLUMN_BLIT
+  fade_set_chain(colblit_nmi);
+#else
+  fade_set_chain(famitone_update);
+#endif
+#ifdef MMC3_SPLIT
+  // sprites from the upper CHR half clock the IRQ counter
+  mmc3_split_init(MMC3_SPLIT_LINE);
+  bank_spr(1);
+  nmi_set_callback(mmc3_split_nmi);
+  __asm__ ("cli");
+#else
+  nmi_set_callback(fade_nmi);
+#endif
   // play music
  music_play(0);
- title_screen();
-
-while(1){
-  
-  clrscr();
-
-  player_score = 0;
-  gameover=0;
-  x_scroll=0;
-  direction=0;
-  // set sprite 0
-  oam_clear();
-  reset_players();
-  
-  //sets sprite 0 to declare split line
-  oam_spr(0, 29, 0xa0, 0x20, 0); 
-  //put_str(NTADR_A(2,2), "Birdie");
-  
-  // set attributes
-  // clear vram buffer
-  //vrambuf_clear();
-  set_vram_update(updbuf);
-  add_score(0);
-  // enable PPU rendering (turn on screen)
-  ppu_on_all();
-  
-      
-  // scroll window back and forth
-  //main portion of the game
-  scroll_demo();
-  ppu_off();
-
-}
-    
+ // title, rounds and game over, one frame at a time
+ sched_run(&title_state, telemetry_wait_nmi);
 }
@@ -0,0 +1,46 @@
+
+// times the per-frame actor work in flappy.c, update_actors and
+// draw_sprite (which queues and draws every live actor), with
+// the bird and 0, 4, 8 or 15 enemies (a full pool)
+//
+// usage: actors_bench [frames]
+// host time only says how the cost grows with the actor count,
+// a PROFILE build under an emulator gives the 6502 cycles
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// (-Dmain=flappy_main renames its main, not ours)
+#include "../flappy.c"
+#undef main
+
+static const byte counts[] = { 0, 4, 8, NUM_ACTORS-1 };
+
+int main(int argc, char** argv) {
+  unsigned long frames = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000000;
+  unsigned long f;
+  byte n, a;
+  clock_t start;
+  double ns, base = 0;
+  reset_players();
+  oam_clear();
+  // nothing scrolls, so the enemies stay put
+  scroll_px = 0;
+  for (n=0; n<sizeof(counts); n++) {
+    init_actors();
+    for (a=1; a<=counts[n]; a++)
+      spawn_actor(a & 1 ? ACTOR_CLOUD : ACTOR_BULLET, a*12, 40+a*8, 0, 0);
+    start = clock();
+    for (f=0; f<frames; f++) {
+      update_actors();
+      draw_sprite();
+    }
+    ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / frames;
+    if (!n)
+      base = ns;
+    printf("%2d enemies: %6.1f ns/frame, %5.2fx the bird alone, "
+           "OAM ends at %d\n", counts[n], ns, ns / base, oam_id);
+  }
+  return 0;
+}
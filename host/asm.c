@@ -0,0 +1,91 @@
+
+// C versions of the assembly modules flappy.c links,
+// doing the same thing as the .s files they stand in for
+
+#include "neslib.h"
+#include "bcd.h"
+#include "fade.h"
+#include "metaspr.h"
+
+// bcd6.s
+
+void bcd_add6(unsigned char* dest, unsigned char bcd) {
+  byte i, lo, hi, carry = 0;
+  for (i=0; i<3; i++) {
+    lo = (dest[i] & 15) + (bcd & 15) + carry;
+    hi = (dest[i] >> 4) + (bcd >> 4);
+    if (lo > 9) {
+      lo -= 10;
+      ++hi;
+    }
+    carry = hi > 9;
+    if (carry)
+      hi -= 10;
+    dest[i] = hi << 4 | lo;
+    // higher bytes only add the carry
+    bcd = 0;
+  }
+}
+
+// fade.s
+
+unsigned char fade_bright;
+unsigned char fade_target;
+unsigned char fade_rate;
+static unsigned char fade_timer;
+static void (*fade_chain)(void);
+
+void fade_nmi(void) {
+  if (fade_bright == fade_target) {
+    // idle, a new fade waits a full step
+    fade_timer = fade_rate;
+  } else if (!--fade_timer) {
+    fade_timer = fade_rate;
+    if (fade_bright < fade_target)
+      ++fade_bright;
+    else
+      --fade_bright;
+    pal_bright(fade_bright);
+  }
+  fade_chain();
+}
+
+void fade_set(unsigned char bright) {
+  fade_target = bright;
+  fade_bright = bright;
+  pal_bright(bright);
+}
+
+void fade_set_chain(void (*f)(void)) {
+  fade_chain = f;
+}
+
+// famitone2.s, the player itself isn't run
+
+void famitone_update(void) {
+}
+
+// music_aftertherain.s, demosounds.s
+
+char after_the_rain_music_data[1];
+char demo_sounds[1];
+
+// metaspr.s, the compiled metasprites draw the same
+// as oam_meta_spr with the tables they were built from
+
+unsigned char metaspr_x;
+unsigned char metaspr_y;
+
+#define METASPR(name)\
+extern const unsigned char name[];\
+void metaspr_##name(unsigned char id) {\
+  oam_meta_spr(metaspr_x, metaspr_y, id, name);\
+}
+
+METASPR(bird)
+METASPR(birdFly)
+METASPR(birdFly2)
+METASPR(bird_down)
+METASPR(enemyCloud)
+METASPR(bulletBill)
+METASPR(CoinsSpr)
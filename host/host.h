@@ -0,0 +1,52 @@
+
+// host build of the game logic, force-included ahead of every
+// source file by the Makefile; points the buffers neslib.h and
+// vrambuf.h keep at fixed NES addresses at ordinary arrays, and
+// declares what the stub neslib records for the driver
+
+#ifndef _HOST_H
+#define _HOST_H
+
+#include "../neslib.h"
+#include "../vrambuf.h"
+
+// OAM buffer, at $200 on the NES
+extern OAMSprite host_oam[64];
+#undef OAMBUF
+#define OAMBUF host_oam
+
+// update buffer, at $100 on the NES
+extern byte host_updbuf[256];
+#undef updbuf
+#define updbuf host_updbuf
+
+// PPU state, nametables with vertical mirroring (NES_MIRRORING 1)
+extern byte host_vram[0x800];
+extern byte host_pal[32];
+extern byte host_bright;	// last pal_bright
+extern byte host_mask;		// last PPU mask, rendering is MASK_BG|MASK_SPR
+extern word host_scroll_x;	// last scroll or split
+extern word host_scroll_y;
+
+// frames (NMIs) since power-on, nesclock() is the low byte
+extern unsigned long host_frames;
+
+// bytes of update buffer the last NMI sent, and the most in one frame
+extern word host_upd_bytes;
+extern word host_upd_max;
+
+// audio calls
+extern unsigned long host_sfx[64];	// sfx_play count by sound
+extern int host_music;			// song playing, -1 if none
+
+// controller 0, as the next pad_poll will read it
+extern byte host_pad;
+
+// called by every ppu_wait_nmi once the NMI work is done,
+// the driver sets host_pad here and longjmps out to stop
+extern void (*host_frame)(void);
+
+// the game's main, flappy.c is built with -Dmain=flappy_main
+void flappy_main(void);
+
+#endif // host.h
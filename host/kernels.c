@@ -0,0 +1,199 @@
+
+// times the small routines the frame is built from: bcd_add,
+// the vrambuf helpers, the nametable helpers in flappy.c and
+// the score's draw_bcd6, against stored baselines
+//
+// usage: kernels_bench [baseline]
+//  with no baseline, prints "name ns" lines to store as one
+//  with one, exits 1 if a kernel takes over SLACK times its line
+// this is host timing, good for catching a routine getting
+// slower, not for 6502 cycles; those need sim65 or a PROFILE
+// build under an emulator (bcd_add6 is asm.c's C stand-in)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// (-Dmain=flappy_main renames its main, not ours)
+#include "../flappy.c"
+#undef main
+
+#define RUN_CLOCKS (CLOCKS_PER_SEC/20)	// least time a count takes
+#define REPEATS	9	// the fastest of this many counts
+// slower than the baseline by more fails; host times move by
+// half again on a busy machine, a real regression is bigger
+#define SLACK	2.0
+
+// results go here, so the calls can't be optimized away
+static volatile word sink;
+
+static const char column[PLAYROWS] = { 1, 2, 3 };
+static byte score[3];
+static byte shown[3];
+
+static void k_bcd_add(unsigned long n) {
+  word w = 0;
+  for (; n; --n)
+    w = bcd_add(w, 0x17);
+  sink = w;
+}
+
+static void k_bcd_add6(unsigned long n) {
+  for (; n; --n)
+    bcd_add6(score, 0x17);
+  sink = score[0];
+}
+
+// a nametable column, as put_columns queues them
+static void k_vrambuf_put(unsigned long n) {
+  for (; n; --n) {
+    vrambuf_clear();
+    vrambuf_put(NTADR_A(2,4) | VRAMBUF_VERT, column, PLAYROWS);
+  }
+}
+
+// a single byte write, as put_attr_entries queues them
+static void k_vrambuf_alloc(unsigned long n) {
+  char* p;
+  for (; n; --n) {
+    vrambuf_clear();
+    p = vrambuf_alloc(3, VRAMBUF_PRI_HUD);
+    p[0] = 0x23;
+    p[1] = 0xc8;
+    p[2] = n;
+    vrambuf_end();
+  }
+}
+
+static void k_nt2attraddr(unsigned long n) {
+  word w = 0;
+  for (; n; --n)
+    w += nt2attraddr(0x2000 + (n & 0x7ff));
+  sink = w;
+}
+
+static void k_fill_buffer(unsigned long n) {
+  for (; n; --n)
+    fill_buffer(n & 31);
+  sink = colmask[0];
+}
+
+// one metatile column and its right half, without new_segment
+static void k_put_columns(unsigned long n) {
+  word addr;
+  byte x;
+  for (; n; --n) {
+    vrambuf_clear();
+    x = n & 31;
+    addr = x < 16 ? NTADR_A(x*2, 4) : NTADR_B((x&15)*2, 4);
+    load_attr_column(nt2attraddr(addr), x);
+    fill_buffer(x);
+    put_columns(addr);
+    put_right_column();
+  }
+}
+
+// the whole column step scroll_left takes every 16 pixels
+static void k_update_offscreen(unsigned long n) {
+  for (; n; --n) {
+    vrambuf_clear();
+    update_offscreen();
+    x_scroll += 16;
+  }
+}
+
+// a score going up by one, some digits to put every time
+static void k_draw_bcd6(unsigned long n) {
+  for (; n; --n) {
+    vrambuf_clear();
+    bcd_add6(score, 1);
+    draw_bcd6(NTADR_A(3,3), score, shown);
+  }
+}
+
+typedef struct Kernel {
+  const char* name;
+  void (*run)(unsigned long n);
+} Kernel;
+
+static const Kernel kernels[] = {
+  { "bcd_add",		k_bcd_add },
+  { "bcd_add6",		k_bcd_add6 },
+  { "vrambuf_put",	k_vrambuf_put },
+  { "vrambuf_alloc",	k_vrambuf_alloc },
+  { "nt2attraddr",	k_nt2attraddr },
+  { "fill_buffer",	k_fill_buffer },
+  { "put_columns",	k_put_columns },
+  { "update_offscreen",	k_update_offscreen },
+  { "draw_bcd6",	k_draw_bcd6 },
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+// ns per call, the fastest of REPEATS runs of enough calls
+// to take RUN_CLOCKS, so the quick kernels aren't all noise
+static double time_kernel(const Kernel* k) {
+  unsigned long calls = 1000;
+  clock_t start, t;
+  double ns, best = 0;
+  byte r;
+  do {
+    calls *= 2;
+    start = clock();
+    k->run(calls);
+    t = clock() - start;
+  } while (t < RUN_CLOCKS);
+  for (r=0; r<REPEATS; r++) {
+    start = clock();
+    k->run(calls);
+    ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / calls;
+    if (!r || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+// the baseline's ns for name, 0 if it has none
+static double baseline_ns(FILE* f, const char* name) {
+  char line[64];
+  char n[32];
+  double ns;
+  rewind(f);
+  while (fgets(line, sizeof(line), f))
+    if (sscanf(line, "%31s %lf", n, &ns) == 2 && !strcmp(n, name))
+      return ns;
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  FILE* f = NULL;
+  const Kernel* k;
+  double ns, base;
+  int failed = 0;
+  if (argc > 1 && !(f = fopen(argv[1], "r"))) {
+    perror(argv[1]);
+    return 1;
+  }
+  // a playfield to draw into, as a round starts
+  init_actors();
+  new_segment();
+  vrambuf_reset();
+  for (k=kernels; k<kernels+NUM_KERNELS; k++) {
+    ns = time_kernel(k);
+    if (!f) {
+      printf("%-16s %.1f\n", k->name, ns);
+      continue;
+    }
+    base = baseline_ns(f, k->name);
+    if (!base) {
+      printf("%-16s %6.1f ns/call, no baseline\n", k->name, ns);
+      continue;
+    }
+    printf("%-16s %6.1f ns/call, baseline %6.1f, %4.2fx%s\n",
+           k->name, ns, base, ns / base,
+           ns > base * SLACK ? "  SLOWER" : "");
+    failed |= ns > base * SLACK;
+  }
+  return failed;
+}
@@ -0,0 +1,117 @@
+
+// headless driver for the host build: runs flappy.c against the
+// stub neslib with an autopilot on the controller, then prints
+// what the stubs recorded
+//
+// usage: flappy_host [frames [seed]]
+//  frames  NES frames to run (default 100000)
+//  seed    pipe generator seed, nonzero (default 0x1234)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <time.h>
+#include "neslib.h"
+
+// flappy.c state the autopilot and the summary look at
+extern byte actor_x[];
+extern byte actor_y[];
+extern byte actor_type[];
+extern word x_scroll;
+extern word colmask[32];
+extern word rng_seed;
+extern word play_frames;
+extern byte gameover;
+extern byte player_score[3];
+extern byte high_score[3];
+
+static jmp_buf host_exit;
+static unsigned long run_frames;	// frames to run
+static unsigned long hash = 2166136261u;	// FNV-1a of OAM and VRAM traffic
+static unsigned long rounds;		// rounds started
+static unsigned long frames_played;	// frames spent in rounds
+static word round_max;			// frames in the longest round
+static word last_play_frames;
+static byte flapped;			// UP was down last frame
+static unsigned long enemy_frames;	// sum of live enemies over frames
+static byte enemy_max;			// most live enemies in one frame
+
+static void hash_bytes(const byte* p, word n) {
+  for (; n; --n)
+    hash = (hash ^ *p++) * 16777619u;
+}
+
+// sprite y to flap at: near the bottom of the opening in the
+// nearest pipe under or ahead of the bird, mid-screen if none
+static byte flap_y(void) {
+  word x = x_scroll + actor_x[0];
+  word mask = 0;
+  byte n, top, bottom;
+  for (n=0; n<4 && !mask; n++, x += 16)
+    mask = colmask[(x >> 4) & 31];
+  if (!mask)
+    return 120;
+  for (top=0; mask & (1 << top); top++) ;
+  for (bottom=top; !(mask & (1 << bottom)); bottom++) ;
+  // a flap rises about 34 pixels before falling again
+  return 32 + bottom*16 - 28;
+}
+
+static void count_enemies(void) {
+  byte a, n = 0;
+  for (a=1; a<16; a++)
+    n += actor_type[a] != 0;
+  enemy_frames += n;
+  if (n > enemy_max)
+    enemy_max = n;
+}
+
+// the end of every frame, after the NMI
+static void frame(void) {
+  hash_bytes((const byte*)host_oam, sizeof(host_oam));
+  hash_bytes(host_updbuf, host_upd_bytes);
+  // play_frames counts from 1 in every round
+  if (play_frames == 1 && last_play_frames != 1)
+    ++rounds;
+  if (play_frames != last_play_frames)
+    ++frames_played;
+  if (play_frames > round_max)
+    round_max = play_frames;
+  last_play_frames = play_frames;
+  count_enemies();
+  if (host_frames == run_frames)
+    longjmp(host_exit, 1);
+  // flap whenever the bird sinks below the opening ahead,
+  // and keep pressing START for the title and game over
+  host_pad = host_frames & 1 ? PAD_START : 0;
+  if (!flapped && !gameover && actor_y[0] > flap_y())
+    host_pad |= PAD_UP;
+  flapped = host_pad & PAD_UP;
+}
+
+int main(int argc, char** argv) {
+  clock_t start;
+  double secs;
+  run_frames = argc > 1 ? strtoul(argv[1], NULL, 0) : 100000;
+  rng_seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 0x1234;
+  host_frame = frame;
+  start = clock();
+  if (!setjmp(host_exit))
+    flappy_main();
+  secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("frames      %lu\n", host_frames);
+  printf("rounds      %lu (%lu frames of play)\n", rounds, frames_played);
+  printf("survival    %lu frames a round on average, %u at most\n",
+         rounds ? frames_played / rounds : 0, round_max);
+  printf("score       %02x%02x%02x, best %02x%02x%02x\n",
+         player_score[2], player_score[1], player_score[0],
+         high_score[2], high_score[1], high_score[0]);
+  printf("sfx         %lu of sound 0 (points, menus), %lu of sound 1 (hits)\n",
+         host_sfx[0], host_sfx[1]);
+  printf("enemies     %.2f live on average, %u at most\n",
+         (double)enemy_frames / host_frames, enemy_max);
+  printf("update buf  %u bytes at most in one frame\n", host_upd_max);
+  printf("hash        %08lx\n", hash & 0xffffffffu);
+  printf("speed       %.0f frames/s\n", secs > 0 ? host_frames / secs : 0);
+  return 0;
+}
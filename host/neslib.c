@@ -0,0 +1,280 @@
+
+// stub neslib for the host build: the same API, with the PPU,
+// OAM and audio kept in memory, and ppu_wait_nmi doing what the
+// NMI handler would before handing the frame to the driver
+
+#include <string.h>
+#include "neslib.h"
+
+OAMSprite host_oam[64];
+byte host_updbuf[256];
+byte host_vram[0x800];
+byte host_pal[32];
+byte host_bright = 4;
+byte host_mask;
+word host_scroll_x;
+word host_scroll_y;
+unsigned long host_frames;
+word host_upd_bytes;
+word host_upd_max;
+unsigned long host_sfx[64];
+int host_music = -1;
+byte host_pad;
+void (*host_frame)(void);
+
+static byte* vram_update;	// set_vram_update buffer, NULL if off
+static void (*nmi_callback)(void);
+static word vram_addr;		// PPU address for vram_put etc.
+static byte vram_step = 1;	// 1, or 32 after vram_inc(1)
+static word rand_seed = 0xfdfd;
+static byte pad_last;		// pad_poll result, for pad_trigger
+
+// a PPU write at addr, palette or nametable
+static void ppu_write(word addr, byte n) {
+  addr &= 0x3fff;
+  if (addr >= 0x3f00)
+    host_pal[addr & 0x1f] = n;
+  else if (addr >= 0x2000)
+    host_vram[addr & 0x7ff] = n;
+}
+
+// send an update buffer to the PPU, returns its size in bytes
+static word send_update(const byte* buf) {
+  const byte* p = buf;
+  word addr;
+  byte len, step;
+  while (*p != NT_UPD_EOF) {
+    if (*p < NT_UPD_HORZ) {
+      // non-sequential write
+      ppu_write(p[0] << 8 | p[1], p[2]);
+      p += 3;
+      continue;
+    }
+    step = *p >= NT_UPD_VERT ? 32 : 1;
+    addr = (p[0] & 0x3f) << 8 | p[1];
+    len = p[2];
+    p += 3;
+    for (; len; --len, addr += step)
+      ppu_write(addr, *p++);
+  }
+  return p - buf;
+}
+
+// palette
+
+void pal_all(const char *data) {
+  memcpy(host_pal, data, 32);
+}
+
+void pal_bg(const char *data) {
+  memcpy(host_pal, data, 16);
+}
+
+void pal_spr(const char *data) {
+  memcpy(host_pal+16, data, 16);
+}
+
+void pal_col(unsigned char index, unsigned char color) {
+  host_pal[index & 0x1f] = color;
+}
+
+void pal_clear(void) {
+  memset(host_pal, 0x0f, 32);
+}
+
+void pal_bright(unsigned char bright) {
+  host_bright = bright;
+}
+
+// PPU
+
+// the NMI: updates only go out with rendering on, like neslib
+void ppu_wait_nmi(void) {
+  host_upd_bytes = 0;
+  if ((host_mask & (MASK_BG|MASK_SPR)) && vram_update) {
+    host_upd_bytes = send_update(vram_update);
+    if (host_upd_bytes > host_upd_max)
+      host_upd_max = host_upd_bytes;
+  }
+  ++host_frames;
+  if (nmi_callback)
+    nmi_callback();
+  if (host_frame)
+    host_frame();
+}
+
+void ppu_wait_frame(void) {
+  ppu_wait_nmi();
+}
+
+// neslib waits for the NMI after switching rendering
+void ppu_off(void) {
+  host_mask &= ~(MASK_BG|MASK_SPR);
+  ppu_wait_nmi();
+}
+
+void ppu_on_all(void) {
+  host_mask |= MASK_BG|MASK_SPR;
+  ppu_wait_nmi();
+}
+
+void ppu_on_bg(void) {
+  host_mask |= MASK_BG;
+  ppu_wait_nmi();
+}
+
+void ppu_mask(unsigned char mask) {
+  host_mask = mask;
+}
+
+unsigned char nesclock(void) {
+  return host_frames;
+}
+
+void nmi_set_callback(void (*callback)(void)) {
+  nmi_callback = callback;
+}
+
+// OAM
+
+void oam_clear(void) {
+  byte i;
+  for (i=0; i<64; i++)
+    host_oam[i].y = 0xff;
+}
+
+unsigned char oam_spr(unsigned char x, unsigned char y,
+                      unsigned char chrnum, unsigned char attr,
+                      unsigned char sprid) {
+  OAMSprite* s = host_oam + (sprid >> 2);
+  s->x = x;
+  s->y = y;
+  s->name = chrnum;
+  s->attr = attr;
+  return sprid + 4;
+}
+
+unsigned char oam_meta_spr(unsigned char x, unsigned char y,
+                           unsigned char sprid, const unsigned char *data) {
+  for (; data[0] != 128; data += 4)
+    sprid = oam_spr(x + data[0], y + data[1], data[2], data[3], sprid);
+  return sprid;
+}
+
+void oam_hide_rest(unsigned char sprid) {
+  do {
+    host_oam[sprid >> 2].y = 240;
+    sprid += 4;
+  } while (sprid);
+}
+
+// audio, only the calls are kept
+
+void famitone_init(void* music_data) {
+  music_data = music_data;
+}
+
+void sfx_init(void* sounds_data) {
+  sounds_data = sounds_data;
+}
+
+void music_play(unsigned char song) {
+  host_music = song;
+}
+
+void music_stop(void) {
+  host_music = -1;
+}
+
+void sfx_play(unsigned char sound, unsigned char channel) {
+  channel = channel;
+  ++host_sfx[sound & 63];
+}
+
+// controllers, only controller 0 is connected
+
+unsigned char pad_poll(unsigned char pad) {
+  pad_last = pad ? 0 : host_pad;
+  return pad_last;
+}
+
+unsigned char pad_trigger(unsigned char pad) {
+  byte last = pad_last;
+  return pad_poll(pad) & ~last;
+}
+
+// scrolling
+
+void scroll(unsigned int x, unsigned int y) {
+  host_scroll_x = x;
+  host_scroll_y = y;
+}
+
+// no sprite 0 to wait for
+void split(unsigned int x, unsigned int y) {
+  y = y;
+  host_scroll_x = x;
+}
+
+// random numbers, the same sequence neslib's generator gives
+
+static byte rand1(void) {
+  byte a = rand_seed;
+  rand_seed = (rand_seed & 0xff00) | (byte)(a << 1 ^ (a & 0x80 ? 0xcf : 0));
+  return rand_seed;
+}
+
+static byte rand2(void) {
+  byte a = rand_seed >> 8;
+  rand_seed = (rand_seed & 0x00ff) | (byte)(a << 1 ^ (a & 0x80 ? 0xd7 : 0)) << 8;
+  return rand_seed >> 8;
+}
+
+unsigned char rand8(void) {
+  // adc takes the carry out of rand2's shift
+  byte carry = rand_seed >> 15;
+  byte a = rand1();
+  return a + rand2() + carry;
+}
+
+unsigned int rand16(void) {
+  byte a = rand1();
+  return a << 8 | rand2();
+}
+
+void set_rand(unsigned int seed) {
+  rand_seed = seed;
+}
+
+// VRAM, with rendering off
+
+void set_vram_update(unsigned char *buf) {
+  vram_update = buf;
+}
+
+void flush_vram_update(unsigned char *buf) {
+  send_update(buf);
+}
+
+void vram_adr(unsigned int adr) {
+  vram_addr = adr;
+}
+
+void vram_put(unsigned char n) {
+  ppu_write(vram_addr, n);
+  vram_addr += vram_step;
+}
+
+void vram_fill(unsigned char n, unsigned int len) {
+  for (; len; --len)
+    vram_put(n);
+}
+
+void vram_inc(unsigned char n) {
+  vram_step = n ? 32 : 1;
+}
+
+void vram_write(const unsigned char *src, unsigned int size) {
+  for (; size; --size)
+    vram_put(*src++);
+}
@@ -0,0 +1,90 @@
+
+// checks the bird's movement in flappy.c frame by frame against
+// a model built straight from the physics defines, with no
+// fall_v table: velocity and position in 8.8 fixed point,
+// gravity added every frame up to terminal velocity
+//
+// usage: physics_check [frames]   (exits 1 on the first mismatch)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// the game itself, for move_bird, read_controller and the defines
+// (-Dmain=flappy_main renames its main, not ours)
+#include "../flappy.c"
+#undef main
+
+// the model, in 1/256 pixels
+#define GRAVITY		(y_acceleration * 256 / 8)
+#define TERMINAL	(MAX_SPEED * 256 / 2)
+#define FLAP		(-FLAP_SPEED * 256)
+#define CEILING		(8 * 256)
+#define FLOOR		(BIRD_FLOOR * 256)
+
+static long model_y;
+static long model_v;
+static byte model_pad;
+
+// read_controller's half of a frame
+static void model_input(byte pad) {
+  if ((pad & PAD_UP) && !(model_pad & PAD_UP) && (model_y >> 8) > 8)
+    model_v = FLAP;
+  else if ((pad & PAD_DOWN) && model_v < 0)
+    // down cuts a flap short, the bird starts falling
+    model_v = 0;
+  model_pad = pad;
+}
+
+// move_bird's half
+static void model_move(void) {
+  model_y += model_v;
+  if (model_v + GRAVITY < TERMINAL)
+    model_v += GRAVITY;
+  else
+    model_v = TERMINAL;
+  if (model_y < CEILING) {
+    // hitting the top stops the climb
+    model_y = CEILING;
+    model_v = 0;
+  } else if (model_y > FLOOR) {
+    model_y = FLOOR;
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned long frames = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+  unsigned long f, ceiling = 0, floor = 0;
+  unsigned long r = 1;
+  long y;
+  reset_players();
+  model_y = actor_y[0] << 8;
+  model_v = 0;
+  pad = model_pad = 0;
+  for (f=0; f<frames; f++) {
+    // random presses, with long enough gaps to reach the floor
+    r = r * 1103515245 + 12345;
+    host_pad = 0;
+    if ((r >> 16) % 23 == 0)
+      host_pad = PAD_UP;
+    else if ((r >> 16) % 97 == 1)
+      host_pad = PAD_DOWN;
+    else if ((f >> 10) & 1)
+      // every other 1024 frames, flap hard into the ceiling
+      host_pad = (f & 4) ? PAD_UP : 0;
+    read_controller();
+    move_bird();
+    model_input(host_pad);
+    model_move();
+    y = (long)actor_y[0] << 8 | bird_yfrac;
+    if (y != model_y || actor_dy[0] != (sbyte)(model_v >> 8)) {
+      printf("frame %lu: y %ld dy %d, model y %ld dy %ld\n",
+             f, y, actor_dy[0], model_y, model_v >> 8);
+      return 1;
+    }
+    ceiling += model_y == CEILING;
+    floor += model_y == FLOOR;
+  }
+  printf("physics ok: %lu frames, %lu at the top, %lu on the floor\n",
+         frames, ceiling, floor);
+  return 0;
+}
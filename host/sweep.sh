@@ -0,0 +1,47 @@
+#!/bin/sh
+# runs flappy_host over a range of seeds, one run per core at a
+# time, and sums up what the runs printed: frames survived in a
+# round, scores, and the most update buffer bytes in one frame
+#
+# usage: sweep.sh [first [count [frames]]]
+#  first   first seed, nonzero (default 1)
+#  count   seeds to run (default 256)
+#  frames  NES frames in each run (default 50000)
+
+first=${1:-1}
+count=${2:-256}
+frames=${3:-50000}
+jobs=$(nproc 2>/dev/null || echo 1)
+
+cd "$(dirname "$0")" || exit 1
+
+# each run's lines go out prefixed with its seed
+seq "$first" $((first + count - 1)) |
+xargs -P "$jobs" -I{} sh -c "./flappy_host $frames {} | sed 's/^/{} /'" |
+awk -v jobs="$jobs" '
+$2 == "rounds" {
+  rounds += $3
+  n = $4; sub(/\(/, "", n); played += n
+  seeds++
+}
+$2 == "survival" && $9 + 0 > longest {
+  longest = $9 + 0; longest_seed = $1
+}
+$2 == "score" {
+  best = $5 + 0; best_sum += best
+  if (best > top) { top = best; top_seed = $1 }
+}
+$2 == "update" && $4 + 0 > upd {
+  upd = $4 + 0; upd_seed = $1
+}
+END {
+  if (!seeds) { print "no runs finished"; exit 1 }
+  printf "seeds       %d, %d at a time\n", seeds, jobs
+  printf "rounds      %d (%d frames of play)\n", rounds, played
+  printf "survival    %d frames a round on average, %d at most (seed %s)\n",
+         rounds ? played / rounds : 0, longest, longest_seed
+  printf "best score  %.1f on average, %06d at most (seed %s)\n",
+         best_sum / seeds, top, top_seed
+  printf "update buf  %d bytes at most in one frame (seed %s)\n",
+         upd, upd_seed
+}'
@@ -0,0 +1,62 @@
+
+#include "neslib.h"
+#include "lz4stream.h"
+
+static const byte* lz_in;	// next compressed byte
+static word lz_lit;		// literals left in this sequence
+static word lz_match;		// match bytes left in this sequence
+static byte lz_off;		// match offset
+static byte lz_token;		// token of this sequence
+static bool lz_matchnext;	// read a match once the literals run out
+static byte lz_pos;		// bytes decoded, mod 256
+static byte lz_ring[LZ4S_WINDOW];	// the last LZ4S_WINDOW bytes
+
+// add the 255-terminated extra length bytes to n
+static word lz_length(word n) {
+  byte b;
+  do {
+    b = *lz_in++;
+    n += b;
+  } while (b == 255);
+  return n;
+}
+
+void lz4s_begin(const byte* in) {
+  lz_in = in;
+  lz_lit = 0;
+  lz_match = 0;
+  lz_matchnext = false;
+  lz_pos = 0;
+}
+
+void lz4s_read(byte* out, byte n) {
+  byte b;
+  while (n) {
+    if (lz_lit) {
+      b = *lz_in++;
+      --lz_lit;
+    } else if (lz_match) {
+      b = lz_ring[(byte)(lz_pos - lz_off) & (LZ4S_WINDOW-1)];
+      --lz_match;
+    } else if (lz_matchnext) {
+      // offset high byte is always 0 with a small window
+      lz_off = lz_in[0];
+      lz_in += 2;
+      lz_match = (lz_token & 15) + 4;
+      if (lz_match == 15+4)
+        lz_match = lz_length(lz_match);
+      lz_matchnext = false;
+      continue;
+    } else {
+      lz_token = *lz_in++;
+      lz_lit = lz_token >> 4;
+      if (lz_lit == 15)
+        lz_lit = lz_length(lz_lit);
+      lz_matchnext = true;
+      continue;
+    }
+    lz_ring[lz_pos++ & (LZ4S_WINDOW-1)] = b;
+    *out++ = b;
+    --n;
+  }
+}
@@ -0,0 +1,21 @@
+
+#ifndef _LZ4STREAM_H
+#define _LZ4STREAM_H
+
+#include "neslib.h"
+
+// LZ4 block decoder that hands out its output a piece at a time,
+// so a nametable can go through the update buffer with rendering on
+// (vram_unlz4 needs rendering off); matches are copied from a ring
+// of the last LZ4S_WINDOW bytes instead of reading VRAM back, so
+// offsets must be at most LZ4S_WINDOW (mktitle.py keeps them there)
+#define LZ4S_WINDOW 32
+
+// start decoding the LZ4 block at in
+void lz4s_begin(const byte* in);
+
+// decode the next n bytes to out
+// (the caller stops at the uncompressed size)
+void lz4s_read(byte* out, byte n);
+
+#endif // lz4stream.h
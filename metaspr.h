@@ -0,0 +1,24 @@
+
+// generated by mkmetaspr.py from flappy.c, do not edit
+
+// where the next compiled metasprite is drawn
+extern unsigned char metaspr_x;
+extern unsigned char metaspr_y;
+#pragma zpsym ("metaspr_x")
+#pragma zpsym ("metaspr_y")
+
+// draw at OAM offset id, hardware sprite count in _LEN
+void __fastcall__ metaspr_bird(unsigned char id);
+#define METASPR_LEN_bird 4
+void __fastcall__ metaspr_birdFly(unsigned char id);
+#define METASPR_LEN_birdFly 4
+void __fastcall__ metaspr_birdFly2(unsigned char id);
+#define METASPR_LEN_birdFly2 4
+void __fastcall__ metaspr_bird_down(unsigned char id);
+#define METASPR_LEN_bird_down 4
+void __fastcall__ metaspr_enemyCloud(unsigned char id);
+#define METASPR_LEN_enemyCloud 4
+void __fastcall__ metaspr_bulletBill(unsigned char id);
+#define METASPR_LEN_bulletBill 4
+void __fastcall__ metaspr_CoinsSpr(unsigned char id);
+#define METASPR_LEN_CoinsSpr 6
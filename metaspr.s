@@ -0,0 +1,260 @@
+;generated by mkmetaspr.py from flappy.c, do not edit
+;each routine takes the OAM offset in A and draws at
+;metaspr_x,metaspr_y, same result as oam_meta_spr
+
+OAM_BUF		=$0200
+
+.segment "ZEROPAGE"
+
+_metaspr_x:	.res 1
+_metaspr_y:	.res 1
+
+.segment "CODE"
+
+	.exportzp _metaspr_x,_metaspr_y
+	.export _metaspr_bird
+	.export _metaspr_birdFly
+	.export _metaspr_birdFly2
+	.export _metaspr_bird_down
+	.export _metaspr_enemyCloud
+	.export _metaspr_bulletBill
+	.export _metaspr_CoinsSpr
+
+_metaspr_bird:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	clc
+	adc #8
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	lda #$06
+	sta OAM_BUF+1,x
+	lda #$07
+	sta OAM_BUF+5,x
+	lda #$16
+	sta OAM_BUF+9,x
+	lda #$17
+	sta OAM_BUF+13,x
+	lda #$00
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	sta OAM_BUF+15,x
+	rts
+
+_metaspr_birdFly:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	clc
+	adc #8
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	lda #$02
+	sta OAM_BUF+1,x
+	lda #$03
+	sta OAM_BUF+5,x
+	lda #$12
+	sta OAM_BUF+9,x
+	lda #$13
+	sta OAM_BUF+13,x
+	lda #$00
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	sta OAM_BUF+15,x
+	rts
+
+_metaspr_birdFly2:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	clc
+	adc #8
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	lda #$04
+	sta OAM_BUF+1,x
+	lda #$05
+	sta OAM_BUF+5,x
+	lda #$14
+	sta OAM_BUF+9,x
+	lda #$15
+	sta OAM_BUF+13,x
+	lda #$00
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	sta OAM_BUF+15,x
+	rts
+
+_metaspr_bird_down:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	clc
+	adc #8
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	lda #$20
+	sta OAM_BUF+1,x
+	lda #$21
+	sta OAM_BUF+5,x
+	lda #$30
+	sta OAM_BUF+9,x
+	lda #$31
+	sta OAM_BUF+13,x
+	lda #$00
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	sta OAM_BUF+15,x
+	rts
+
+_metaspr_enemyCloud:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	clc
+	adc #8
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	lda #$5c
+	sta OAM_BUF+1,x
+	lda #$5d
+	sta OAM_BUF+5,x
+	lda #$6c
+	sta OAM_BUF+9,x
+	lda #$6d
+	sta OAM_BUF+13,x
+	lda #$00
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	sta OAM_BUF+15,x
+	rts
+
+_metaspr_bulletBill:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	clc
+	adc #8
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	lda #$5e
+	sta OAM_BUF+1,x
+	lda #$5f
+	sta OAM_BUF+5,x
+	lda #$6e
+	sta OAM_BUF+9,x
+	lda #$6f
+	sta OAM_BUF+13,x
+	lda #$00
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	sta OAM_BUF+15,x
+	rts
+
+_metaspr_CoinsSpr:
+
+	tax
+	lda _metaspr_y
+	sta OAM_BUF+0,x
+	sta OAM_BUF+4,x
+	sta OAM_BUF+8,x
+	sta OAM_BUF+12,x
+	sta OAM_BUF+16,x
+	sta OAM_BUF+20,x
+	lda #$7b
+	sta OAM_BUF+1,x
+	lda #$7d
+	sta OAM_BUF+13,x
+	lda #$7e
+	sta OAM_BUF+21,x
+	lda #$82
+	sta OAM_BUF+5,x
+	sta OAM_BUF+17,x
+	lda #$8b
+	sta OAM_BUF+9,x
+	lda #$03
+	sta OAM_BUF+2,x
+	sta OAM_BUF+6,x
+	sta OAM_BUF+10,x
+	sta OAM_BUF+14,x
+	sta OAM_BUF+18,x
+	sta OAM_BUF+22,x
+	lda _metaspr_x
+	sta OAM_BUF+3,x
+	clc
+	adc #8
+	sta OAM_BUF+7,x
+	clc
+	adc #8
+	sta OAM_BUF+11,x
+	clc
+	adc #8
+	sta OAM_BUF+15,x
+	clc
+	adc #8
+	sta OAM_BUF+19,x
+	clc
+	adc #8
+	sta OAM_BUF+23,x
+	rts
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# generate collision_masks.h from the pattern data in chr_generic.s
+# usage: python3 mkcollision.py > collision_masks.h
+
+import re
+import sys
+
+# 2x2 metasprites from flappy.c (name, top-left tile)
+SPRITES = [
+    ("bird", 0x06),
+    ("birdFly", 0x02),
+    ("birdFly2", 0x04),
+    ("bird_down", 0x20),
+]
+
+# pipe tiles, PIPE_CHAR..PIPE_CHAR+2 in flappy.c
+PIPE_CHAR = 0xDF
+PIPE_TILES = 3
+
+
+def read_chr(path):
+    data = []
+    with open(path) as f:
+        for line in f:
+            m = re.match(r"\s*\.byte\s+(.*)", line)
+            if m:
+                data += [int(b.strip().lstrip("$"), 16)
+                         for b in m.group(1).split(",")]
+    return data
+
+
+def tile_rows(chr, tile):
+    # a pixel is solid if either bitplane has it set
+    base = tile * 16
+    return [chr[base + r] | chr[base + 8 + r] for r in range(8)]
+
+
+def sprite_rows(chr, code):
+    top = zip(tile_rows(chr, code), tile_rows(chr, code + 1))
+    bottom = zip(tile_rows(chr, code + 16), tile_rows(chr, code + 17))
+    return [(l << 8) | r for l, r in list(top) + list(bottom)]
+
+
+def main():
+    chr = read_chr("chr_generic.s")
+    out = sys.stdout
+    out.write("\n// generated by mkcollision.py from chr_generic.s, do not edit\n")
+    out.write("// one row per line, bit 15 (bit 7 for tiles) is the leftmost pixel\n")
+    for name, code in SPRITES:
+        rows = sprite_rows(chr, code)
+        out.write("\nconst unsigned short %s_mask[16]={\n" % name)
+        for i in range(0, 16, 8):
+            out.write(",".join("0x%04x" % r for r in rows[i:i+8]) + ",\n")
+        out.write("};\n")
+    out.write("\nconst unsigned char pipe_tile_mask[%d][8]={\n" % PIPE_TILES)
+    for t in range(PIPE_TILES):
+        rows = tile_rows(chr, PIPE_CHAR + t)
+        out.write("{" + ",".join("0x%02x" % r for r in rows) + "},\n")
+    out.write("};\n")
+
+
+main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# compile the metasprite tables in flappy.c into straight-line
+# OAM writers, so drawing one doesn't walk its table at run time
+# usage: python3 mkmetaspr.py   (writes metaspr.s and metaspr.h)
+#
+# each routine is void __fastcall__ metaspr_<name>(byte id)
+# and draws at metaspr_x,metaspr_y exactly like
+# oam_meta_spr(metaspr_x, metaspr_y, id, <name>) would
+
+import re
+
+# plain tables to compile besides the DEF_METASPRITE_2x2 ones
+TABLES = ["CoinsSpr"]
+
+
+def number(s):
+    return int(s, 0)
+
+
+def read_sprites(path):
+    src = open(path).read()
+    attr = number(re.search(r"#define\s+bird_color\s+(\w+)", src).group(1))
+    sprites = []
+    # same layout as the DEF_METASPRITE_2x2 macro
+    for m in re.finditer(r"^DEF_METASPRITE_2x2\((\w+),\s*(\w+),", src, re.M):
+        code = number(m.group(2))
+        sprites.append((m.group(1), [
+            (0, 0, code, attr),
+            (8, 0, code + 1, attr),
+            (0, 8, code + 16, attr),
+            (8, 8, code + 17, attr),
+        ]))
+    for name in TABLES:
+        m = re.search(r"const unsigned char %s\[\]=\{(.*?)\};" % name,
+                      src, re.S)
+        values = [number(v) for v in re.findall(r"\w+", m.group(1))]
+        assert values[-1] == 128 and len(values) % 4 == 1, name
+        sprites.append((name, [tuple(values[i:i+4])
+                               for i in range(0, len(values) - 1, 4)]))
+    return sprites
+
+
+def store_offsets(out, var, field, parts):
+    # parts is (offset, tile index) pairs, each distinct offset
+    # is one add from the previous, with every store sharing it
+    out.write("\tlda %s\n" % var)
+    last = 0
+    for off in sorted(set(p[0] for p in parts)):
+        if off != last:
+            out.write("\tclc\n\tadc #%d\n" % ((off - last) & 255))
+            last = off
+        for o, i in parts:
+            if o == off:
+                out.write("\tsta OAM_BUF+%d,x\n" % (i * 4 + field))
+
+
+def store_constants(out, field, values):
+    for v in sorted(set(values)):
+        out.write("\tlda #$%02x\n" % v)
+        for i, w in enumerate(values):
+            if w == v:
+                out.write("\tsta OAM_BUF+%d,x\n" % (i * 4 + field))
+
+
+def write_asm(out, sprites):
+    out.write(";generated by mkmetaspr.py from flappy.c, do not edit\n")
+    out.write(";each routine takes the OAM offset in A and draws at\n")
+    out.write(";metaspr_x,metaspr_y, same result as oam_meta_spr\n\n")
+    out.write("OAM_BUF\t\t=$0200\n\n")
+    out.write(".segment \"ZEROPAGE\"\n\n")
+    out.write("_metaspr_x:\t.res 1\n")
+    out.write("_metaspr_y:\t.res 1\n\n")
+    out.write(".segment \"CODE\"\n\n")
+    out.write("\t.exportzp _metaspr_x,_metaspr_y\n")
+    for name, tiles in sprites:
+        out.write("\t.export _metaspr_%s\n" % name)
+    for name, tiles in sprites:
+        out.write("\n_metaspr_%s:\n\n\ttax\n" % name)
+        # OAM order is y, tile, attribute, x
+        store_offsets(out, "_metaspr_y", 0,
+                      [(t[1], i) for i, t in enumerate(tiles)])
+        store_constants(out, 1, [t[2] for t in tiles])
+        store_constants(out, 2, [t[3] for t in tiles])
+        store_offsets(out, "_metaspr_x", 3,
+                      [(t[0], i) for i, t in enumerate(tiles)])
+        out.write("\trts\n")
+
+
+def write_header(out, sprites):
+    out.write("\n// generated by mkmetaspr.py from flappy.c, do not edit\n")
+    out.write("\n// where the next compiled metasprite is drawn\n")
+    out.write("extern unsigned char metaspr_x;\n")
+    out.write("extern unsigned char metaspr_y;\n")
+    out.write("#pragma zpsym (\"metaspr_x\")\n")
+    out.write("#pragma zpsym (\"metaspr_y\")\n\n")
+    out.write("// draw at OAM offset id, hardware sprite count in _LEN\n")
+    for name, tiles in sprites:
+        out.write("void __fastcall__ metaspr_%s(unsigned char id);\n" % name)
+        out.write("#define METASPR_LEN_%s %d\n" % (name, len(tiles)))
+
+
+def main():
+    sprites = read_sprites("flappy.c")
+    with open("metaspr.s", "w") as out:
+        write_asm(out, sprites)
+    with open("metaspr.h", "w") as out:
+        write_header(out, sprites)
+
+
+main()
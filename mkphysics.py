@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# generate bird_physics.h from the physics defines in flappy.c
+# usage: python3 mkphysics.py > bird_physics.h
+#        then make -C host check
+#
+#  y_acceleration  gravity in 1/8 pixels per frame per frame
+#  MAX_SPEED       terminal velocity in 1/2 pixels per frame
+#  FLAP_SPEED      upward speed right after a flap, pixels per frame
+
+import re
+import sys
+
+
+def read_defines(path, names):
+    values = {}
+    with open(path) as f:
+        for line in f:
+            m = re.match(r"#define\s+(\w+)\s+(-?\d+)\b", line)
+            if m and m.group(1) in names:
+                values[m.group(1)] = int(m.group(2))
+    return [values[n] for n in names]
+
+
+def reference(gravity, terminal, flap, t):
+    # velocity t frames after a flap, computed directly
+    return min(flap + gravity * t, terminal)
+
+
+def main():
+    accel, max_speed, flap_speed = read_defines(
+        "flappy.c", ["y_acceleration", "MAX_SPEED", "FLAP_SPEED"])
+    # everything in 1/256 pixels (8.8 fixed point)
+    gravity = accel * 256 // 8
+    terminal = max_speed * 256 // 2
+    flap = -flap_speed * 256
+    frames = -(-(terminal - flap) // gravity)
+    table = [reference(gravity, terminal, flap, t) for t in range(frames + 1)]
+    rest = next(t for t, v in enumerate(table) if v >= 0)
+
+    # move_bird is checked against a frame by frame model
+    # by make -C host check (host/physics.c)
+    assert table[-1] == terminal and -32768 <= flap
+
+    out = sys.stdout
+    out.write("\n// generated by mkphysics.py from flappy.c, do not edit\n")
+    out.write("\n// frames from a flap to terminal velocity\n")
+    out.write("#define FALL_FRAMES %d\n" % frames)
+    out.write("// first frame of a flap with a downward velocity\n")
+    out.write("#define FALL_T_REST %d\n" % rest)
+    out.write("\n// bird velocity in 1/256 pixels per frame, t frames after a flap\n")
+    out.write("const int fall_v[FALL_FRAMES+1]={\n")
+    for i in range(0, len(table), 8):
+        out.write(",".join("%d" % v for v in table[i:i+8]) + ",\n")
+    out.write("};\n")
+
+
+main()
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# generate title_lz4.h from the RLE nametable in flappyBird_titlescreen.h
+# usage: python3 mktitle.py > title_lz4.h
+#
+# the output is a standard LZ4 block, so vram_unlz4 can unpack it
+# with rendering off, but match offsets are kept under WINDOW so
+# lz4stream.c can also unpack it a few rows per frame from a
+# WINDOW-byte ring buffer with rendering on
+
+import re
+import sys
+
+WINDOW = 32		# LZ4S_WINDOW in lz4stream.h
+MIN_MATCH = 4
+LAST_LITERALS = 5	# LZ4 ends every block with at least 5 literals
+MATCH_LIMIT = 12	# and starts no match in the last 12 bytes
+
+
+def read_rle(path):
+    src = open(path).read()
+    return [int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", src)]
+
+
+def unrle(data):
+    # neslib's rletag format: tag byte, then literals, and
+    # tag,count repeats the previous byte count times (0 ends)
+    tag = data[0]
+    out = []
+    i = 1
+    while True:
+        b = data[i]
+        i += 1
+        if b != tag:
+            out.append(b)
+            continue
+        n = data[i]
+        i += 1
+        if n == 0:
+            return out
+        out += [out[-1]] * n
+
+
+def put_length(out, n):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def sequence(out, literals, match, offset):
+    token = min(len(literals), 15) << 4
+    if match:
+        token |= min(match - MIN_MATCH, 15)
+    out.append(token)
+    if len(literals) >= 15:
+        put_length(out, len(literals) - 15)
+    out += literals
+    if match:
+        out += [offset & 255, offset >> 8]
+        if match - MIN_MATCH >= 15:
+            put_length(out, match - MIN_MATCH - 15)
+
+
+def longest_match(data, pos):
+    best, offset = 0, 0
+    for off in range(1, min(WINDOW, pos) + 1):
+        n = 0
+        while (pos + n < len(data) - LAST_LITERALS and
+               data[pos + n - off] == data[pos + n]):
+            n += 1
+        if n > best:
+            best, offset = n, off
+    return best, offset
+
+
+def lz4(data):
+    # greedy, with one step of lookahead
+    out = []
+    anchor = pos = 0
+    while pos < len(data) - MATCH_LIMIT:
+        n, off = longest_match(data, pos)
+        if n >= MIN_MATCH and longest_match(data, pos + 1)[0] <= n:
+            sequence(out, data[anchor:pos], n, off)
+            pos += n
+            anchor = pos
+        else:
+            pos += 1
+    sequence(out, data[anchor:], 0, 0)
+    return out
+
+
+def unlz4(data, size):
+    # same walk as lz4stream.c, ring buffer and all
+    ring = [0] * WINDOW
+    out = []
+    i = 0
+    while len(out) < size:
+        token = data[i]
+        i += 1
+        n = token >> 4
+        if n == 15:
+            while True:
+                n += data[i]
+                i += 1
+                if data[i - 1] != 255:
+                    break
+        for b in data[i:i+n]:
+            ring[len(out) % WINDOW] = b
+            out.append(b)
+        i += n
+        if len(out) >= size:
+            break
+        off = data[i] | (data[i + 1] << 8)
+        i += 2
+        assert 1 <= off <= WINDOW
+        n = (token & 15) + MIN_MATCH
+        if n == 15 + MIN_MATCH:
+            while True:
+                n += data[i]
+                i += 1
+                if data[i - 1] != 255:
+                    break
+        for _ in range(n):
+            b = ring[(len(out) - off) % WINDOW]
+            ring[len(out) % WINDOW] = b
+            out.append(b)
+    return out[:size]
+
+
+def main():
+    rle = read_rle("flappyBird_titlescreen.h")
+    nt = unrle(rle)
+    assert len(nt) == 1024
+    packed = lz4(nt)
+    assert unlz4(packed, len(nt)) == nt
+    out = sys.stdout
+    out.write("\n// generated by mktitle.py from flappyBird_titlescreen.h, do not edit\n")
+    out.write("// %d bytes of nametable in %d bytes of LZ4 (the RLE was %d)\n"
+              % (len(nt), len(packed), len(rle)))
+    out.write("// match offsets are at most %d\n" % WINDOW)
+    out.write("\n#define TITLE_SIZE %d\n" % len(nt))
+    out.write("\nconst unsigned char title_lz4[%d]={\n" % len(packed))
+    for i in range(0, len(packed), 16):
+        out.write(",".join("0x%02x" % b for b in packed[i:i+16]) + ",\n")
+    out.write("};\n")
+
+
+main()
@@ -0,0 +1,30 @@
+
+#ifndef _MMC3SPLIT_H
+#define _MMC3SPLIT_H
+
+// scanline the status bar split IRQ comes at,
+// the same place sprite zero hits for split()
+#define MMC3_SPLIT_LINE 29
+
+// playfield X scroll, latched by the NMI for the frame it starts
+// when mmc3_split_new is set, so set it with mmc3_split_set
+extern unsigned int mmc3_split_x;
+extern unsigned char mmc3_split_new;
+
+// an NMI between the two bytes of x sees mmc3_split_new clear
+// and keeps the last scroll, rather than half of each
+#define mmc3_split_set(x) \
+  (mmc3_split_new = 0, mmc3_split_x = (x), mmc3_split_new = 1)
+
+// nonzero to split frames from the next NMI on
+extern unsigned char mmc3_split_on;
+
+// NMI and IRQ callback, set with nmi_set_callback
+// after fade_set_chain, it runs fade_nmi
+void __fastcall__ mmc3_split_nmi(void);
+
+// set up the mapper, the IRQ comes at scanline line
+// (sprites then need bank_spr(1), and IRQs enabling)
+void __fastcall__ mmc3_split_init(unsigned char line);
+
+#endif // mmc3split.h
@@ -0,0 +1,103 @@
+;status bar split from an MMC3 scanline IRQ, instead of
+;busy-waiting for the sprite-zero hit; the main loop sets
+;mmc3_split_x and mmc3_split_on, the NMI latches them for
+;the frame it starts and arms the IRQ, which sets the scroll;
+;mmc3_split_new is set once both bytes of mmc3_split_x are
+;written, without it the NMI keeps the last frame's scroll
+
+PPU_CTRL	=$2000
+PPU_STATUS	=$2002
+PPU_SCROLL	=$2005
+MMC3_BANK_SEL	=$8000
+MMC3_BANK_DATA	=$8001
+MMC3_MIRRORING	=$a000
+MMC3_IRQ_LATCH	=$c000
+MMC3_IRQ_RELOAD	=$c001
+MMC3_IRQ_OFF	=$e000
+MMC3_IRQ_ON	=$e001
+
+	.import _fade_nmi
+	.import _get_ppu_ctrl_var
+
+.segment "BSS"
+
+_mmc3_split_x:	.res 2	;playfield X scroll for the next frame
+_mmc3_split_on:	.res 1	;nonzero to split the next frame
+_mmc3_split_new:	.res 1	;nonzero when _mmc3_split_x is whole and new
+split_ctrl:	.res 1	;PPU_CTRL for this frame's playfield
+split_lo:	.res 1	;X scroll for this frame's playfield
+
+.segment "CODE"
+
+	.export _mmc3_split_x,_mmc3_split_on,_mmc3_split_new
+	.export _mmc3_split_nmi,_mmc3_split_init
+
+;NMI and IRQ callback, neslib calls it for both,
+;with bit 7 of A set for the IRQ
+
+_mmc3_split_nmi:
+
+	and #$80
+	bne @irq
+
+	sta MMC3_IRQ_OFF	;acknowledge, and stay off unless armed
+	lda _mmc3_split_on
+	beq @done
+	lda _mmc3_split_new
+	beq @arm		;mid-write or unchanged, keep the last latch
+	lda #0
+	sta _mmc3_split_new
+	lda _mmc3_split_x+1
+	and #1			;nametable B past x=255
+	sta split_ctrl
+	jsr _get_ppu_ctrl_var
+	and #$fc
+	ora split_ctrl
+	sta split_ctrl
+	lda _mmc3_split_x
+	sta split_lo
+
+@arm:
+
+	sta MMC3_IRQ_RELOAD	;count from the latch this frame
+	sta MMC3_IRQ_ON
+
+@done:
+
+	jmp _fade_nmi		;fades, then music
+
+@irq:
+
+	sta MMC3_IRQ_OFF	;acknowledge, one split per frame
+	lda split_ctrl
+	sta PPU_CTRL
+	bit PPU_STATUS		;reset the scroll write toggle
+	lda split_lo
+	sta PPU_SCROLL
+	lda #0
+	sta PPU_SCROLL
+	rts
+
+;void __fastcall__ mmc3_split_init(unsigned char line);
+;maps the 4K pattern table into both halves of CHR, so sprites
+;can come from $1000 and clock the IRQ counter once a scanline,
+;maps PRG like NROM and sets vertical mirroring; the IRQ comes
+;at scanline line, the playfield starts below it
+
+_mmc3_split_init:
+
+	sta MMC3_IRQ_LATCH
+	ldx #7
+@bank:
+	stx MMC3_BANK_SEL
+	lda mmc3_banks,x
+	sta MMC3_BANK_DATA
+	dex
+	bpl @bank
+	lda #0
+	sta MMC3_MIRRORING	;vertical, as NES_MIRRORING 1
+	rts
+
+;R0-R1 2K banks at $0000, R2-R5 1K banks at $1000,
+;R6-R7 8K PRG banks at $8000 and $a000
+mmc3_banks:	.byte 0,2,0,1,2,3,0,1
@@ -0,0 +1,57 @@
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include "neslib.h"
+
+// section IDs written to prof_section
+// a profiler attributes all cycles up to the next write
+// to the section last written
+#define PROF_IDLE	0	// waiting for NMI / state setup
+#define PROF_INPUT	1	// read_controller
+#define PROF_SPRITES	2	// draw_sprite (incl. oam_meta_spr)
+#define PROF_UPDATE	3	// update (collision, fades)
+#define PROF_SCORE	4	// check_score and the score HUD
+#define PROF_SPLIT	5	// split (sprite zero busy wait)
+#define PROF_SCROLL	6	// scroll_left / update_offscreen / fill_buffer
+#define PROF_ACTORS	7	// update_actors (enemy handlers)
+
+#ifdef PROFILE
+
+// current section; look up _prof_section in the ld65 map
+extern byte prof_section;
+// incremented once per scheduler frame
+extern word prof_frame;
+
+#define PROF_MARK(id) prof_section = (id);
+#define PROF_FRAME() ++prof_frame;
+
+#else
+
+#define PROF_MARK(id)
+#define PROF_FRAME()
+
+#endif
+
+// lag telemetry (build with -DTELEMETRY)
+//  -DTELEMETRY_HUD also shows the lag count in the status bar
+//  -DTELEMETRY_TINT greys out the screen from the scanline
+//   where the main loop finished down to vblank
+
+#ifdef TELEMETRY
+
+typedef struct Telemetry {
+  word lag_frames;	// frames where the NMI fired before the wait
+  word lag_bcd;		// lag_frames in BCD for the HUD
+  byte frame_done;	// incremented when the main loop reaches its wait
+  byte last_clock;	// nesclock() when the last wait returned
+} Telemetry;
+
+// look up _telemetry in the ld65 map
+// a harness can timestamp writes to frame_done
+// to get the scanline where each frame's work ended
+extern Telemetry telemetry;
+
+#endif
+
+#endif // profile.h
@@ -0,0 +1,93 @@
+
+#include "neslib.h"
+#include "replay.h"
+
+#ifdef RECORD_INPUT
+
+byte replay_buf[REPLAY_BUFSIZE];
+byte replay_len;
+bool replay_full;
+
+word replay_begin(word seed) {
+  replay_buf[0] = seed;
+  replay_buf[1] = seed >> 8;
+  replay_buf[2] = 0;
+  replay_buf[3] = 0;
+  replay_len = 2;
+  replay_full = false;
+  return seed;
+}
+
+byte replay_pad_poll(void) {
+  byte pad = pad_poll(0);
+  // once a frame is dropped, later ones would replay out of step
+  if (replay_full)
+    return pad;
+  // extend the current run if the pad did not change
+  if (replay_len > 2 && replay_buf[replay_len-2] == pad
+      && replay_buf[replay_len-1] != 255) {
+    ++replay_buf[replay_len-1];
+  }
+  // otherwise start a new run, keeping room for the end marker
+  else if (replay_len < REPLAY_BUFSIZE-4) {
+    replay_buf[replay_len++] = pad;
+    replay_buf[replay_len++] = 1;
+    replay_buf[replay_len] = 0;
+    replay_buf[replay_len+1] = 0;
+  }
+  // no room for the run this frame needs, stop here
+  else {
+    replay_full = true;
+  }
+  return pad;
+}
+
+byte replay_pad_trigger(void) {
+  return pad_trigger(0);
+}
+
+#elif defined(REPLAY_INPUT)
+
+static const byte* replay_ptr;	// next run in replay_data
+static byte replay_pad;		// pad state of the current run
+static byte replay_run;		// frames left in the current run
+
+word replay_begin(word seed) {
+  seed = seed;
+  replay_ptr = replay_data + 2;
+  replay_run = 0;
+  return replay_data[0] | (replay_data[1] << 8);
+}
+
+byte replay_pad_poll(void) {
+  if (!replay_run) {
+    // end of stream, release all buttons
+    if (!replay_ptr[1])
+      return 0;
+    replay_pad = replay_ptr[0];
+    replay_run = replay_ptr[1];
+    replay_ptr += 2;
+  }
+  --replay_run;
+  return replay_pad;
+}
+
+byte replay_pad_trigger(void) {
+  return PAD_START;
+}
+
+#else
+
+word replay_begin(word seed) {
+  return seed;
+}
+
+byte replay_pad_poll(void) {
+  return pad_poll(0);
+}
+
+byte replay_pad_trigger(void) {
+  return pad_trigger(0);
+}
+
+#endif
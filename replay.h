@@ -0,0 +1,44 @@
+
+#ifndef _REPLAY_H
+#define _REPLAY_H
+
+#include "neslib.h"
+
+// uncomment one of these to record or play back controller 0
+//#define RECORD_INPUT
+//#define REPLAY_INPUT
+
+// recording format:
+//  seed LSB, seed MSB (rand8 seed in effect when play starts)
+//  pad, count (run of count frames with the same pad_poll result)
+//  ...
+//  0, 0 (end of stream)
+
+#ifdef RECORD_INPUT
+// RAM recording buffer, recording stops when it fills up
+#define REPLAY_BUFSIZE 256
+extern byte replay_buf[REPLAY_BUFSIZE];
+// index of the end marker in replay_buf
+extern byte replay_len;
+// set when a frame didn't fit, the recording ends before it
+extern bool replay_full;
+#endif
+
+#ifdef REPLAY_INPUT
+// recorded stream, linked in from a separate file
+extern const byte replay_data[];
+#endif
+
+// start a run with the given seed
+// returns the seed to pass to set_rand
+// (the recorded seed when playing back)
+word replay_begin(word seed);
+
+// poll controller 0, recording or substituting the result
+byte replay_pad_poll(void);
+
+// poll controller 0 in trigger mode for the title and game over screens
+// during playback these screens are skipped by pressing START
+byte replay_pad_trigger(void);
+
+#endif // replay.h
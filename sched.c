@@ -0,0 +1,60 @@
+
+#include "neslib.h"
+#include "vrambuf.h"
+#include "profile.h"
+#include "sched.h"
+
+// state the tasks belong to
+static const SchedState* sched_state;
+
+// state to switch to at the next frame boundary
+static const SchedState* sched_next;
+
+// bit n set if task n was put off to this frame
+static byte sched_deferred;
+
+void sched_goto(const SchedState* s) {
+  sched_next = s;
+}
+
+void sched_run(const SchedState* s, void (*frame_wait)(void)) {
+  const Task* t;
+  word used, budget;
+  byte bit, clock;
+  sched_next = s;
+  while (1) {
+    if (sched_next) {
+      sched_state = sched_next;
+      sched_next = NULL;
+      sched_deferred = 0;
+      if (sched_state->enter)
+        sched_state->enter();
+    }
+    PROF_MARK(PROF_IDLE);
+    frame_wait();
+    clock = nesclock();
+    // the NMI has taken this frame's updates
+    vrambuf_clear();
+    PROF_FRAME();
+    used = 0;
+    bit = 1;
+    for (t=sched_state->tasks; t->run && !sched_next; ++t, bit <<= 1) {
+      budget = t->cycles;
+      if (t->extra)
+        budget += t->extra();
+      // the frame is long if this task's budget doesn't fit
+      // after the ones that ran, or (the NES has no cycle timer
+      // to catch a bad estimate) the NMI already came; a
+      // deferrable task then waits, unless it waited last frame
+      if ((t->flags & TASK_DEFER) && !(sched_deferred & bit) &&
+          (used + budget > SCHED_FRAME_CYCLES || nesclock() != clock)) {
+        sched_deferred |= bit;
+        continue;
+      }
+      used += budget;
+      sched_deferred &= ~bit;
+      PROF_MARK(t->prof);
+      t->run();
+    }
+  }
+}
@@ -0,0 +1,41 @@
+
+#ifndef _SCHED_H
+#define _SCHED_H
+
+#include "neslib.h"
+
+// main loop CPU cycles per frame, what's left of the
+// ~29780 NTSC frame after the NMI handler (OAM DMA,
+// update buffer, fades and music)
+#define SCHED_FRAME_CYCLES 25000
+
+// most tasks in one state, deferrals are kept in a byte
+#define SCHED_MAX_TASKS 8
+
+// task flags
+#define TASK_DEFER	1	// may wait a frame when the frame runs long
+
+// one piece of per-frame work
+typedef struct Task {
+  void (*run)(void);
+  word cycles;		// budget, CPU cycles it always takes
+  byte flags;
+  byte prof;		// profile.h section while running
+  word (*extra)(void);	// cycles on top for this frame, NULL if none
+} Task;
+
+// a game state, a list of tasks run in order once per frame
+typedef struct SchedState {
+  void (*enter)(void);	// setup, NULL if none (may turn the PPU off)
+  const Task* tasks;	// ends with a NULL run
+} SchedState;
+
+// switch to state s at the next frame boundary,
+// the rest of this frame's tasks are skipped
+void sched_goto(const SchedState* s);
+
+// run the game starting in state s, never returns
+// frame_wait is the one place a frame ends
+void sched_run(const SchedState* s, void (*frame_wait)(void));
+
+#endif // sched.h
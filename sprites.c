@@ -0,0 +1,101 @@
+
+#include "neslib.h"
+#include "sprites.h"
+#include "metaspr.h"
+
+// this frame's draw requests
+static byte spr_count;
+static byte spr_x[SPR_MAX_REQ];
+static byte spr_y[SPR_MAX_REQ];
+static byte spr_pri[SPR_MAX_REQ];
+static byte spr_len[SPR_MAX_REQ];	// hardware sprites in metasprite
+static const unsigned char* spr_data[SPR_MAX_REQ];
+static metaspr_fn spr_fn[SPR_MAX_REQ];	// NULL to use spr_data
+
+// requests in SPR_PRI_ACTOR and up, in request order
+static byte spr_rotlist[SPR_MAX_REQ];
+
+// where the rotating group starts this frame
+static byte spr_rot;
+
+// OAM byte after the last sprite of the previous frame
+static word spr_last_end;
+
+// next free OAM byte
+static word spr_id;
+
+void spr_begin(void) {
+  spr_count = 0;
+}
+
+void spr_request(byte x, byte y, const unsigned char* data, byte pri) {
+  byte n;
+  if (spr_count == SPR_MAX_REQ)
+    return;
+  // count hardware sprites up to the 128 end marker
+  for (n=0; data[n*4] != 128; n++) ;
+  spr_x[spr_count] = x;
+  spr_y[spr_count] = y;
+  spr_pri[spr_count] = pri;
+  spr_len[spr_count] = n;
+  spr_data[spr_count] = data;
+  spr_fn[spr_count] = NULL;
+  ++spr_count;
+}
+
+void spr_request_fn(byte x, byte y, metaspr_fn fn, byte len, byte pri) {
+  if (spr_count == SPR_MAX_REQ)
+    return;
+  spr_x[spr_count] = x;
+  spr_y[spr_count] = y;
+  spr_pri[spr_count] = pri;
+  spr_len[spr_count] = len;
+  spr_fn[spr_count] = fn;
+  ++spr_count;
+}
+
+// draw request i if all of it still fits in OAM
+static void spr_draw(byte i) {
+  if (spr_id + spr_len[i]*4 <= 256) {
+    if (spr_fn[i]) {
+      metaspr_x = spr_x[i];
+      metaspr_y = spr_y[i];
+      spr_fn[i](spr_id);
+    } else {
+      oam_meta_spr(spr_x[i], spr_y[i], spr_id, spr_data[i]);
+    }
+    spr_id += spr_len[i]*4;
+  }
+}
+
+byte spr_end(void) {
+  byte i, n, j;
+  spr_id = SPR_FIRST_ID;
+  // fixed priorities in request order
+  for (j=0; j<SPR_PRI_ACTOR; j++) {
+    for (i=0; i<spr_count; i++) {
+      if (spr_pri[i] == j)
+        spr_draw(i);
+    }
+  }
+  // actors start one further along each frame so whichever
+  // ones don't fit (or don't fit on a scanline) take turns
+  n = 0;
+  for (i=0; i<spr_count; i++) {
+    if (spr_pri[i] >= SPR_PRI_ACTOR)
+      spr_rotlist[n++] = i;
+  }
+  if (n) {
+    j = ++spr_rot % n;
+    for (i=0; i<n; i++) {
+      spr_draw(spr_rotlist[j]);
+      if (++j == n)
+        j = 0;
+    }
+  }
+  // hide only what the last frame drew past this frame's end
+  for (; spr_last_end > spr_id; spr_last_end -= 4)
+    OAMBUF[(spr_last_end-4) >> 2].y = 240;
+  spr_last_end = spr_id;
+  return (byte)spr_id;
+}
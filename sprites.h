@@ -0,0 +1,40 @@
+
+#ifndef _SPRITES_H
+#define _SPRITES_H
+
+#include "neslib.h"
+
+// maximum metasprite draw requests per frame
+#define SPR_MAX_REQ 24
+
+// first OAM byte the manager uses, sprite 0 is the split
+#define SPR_FIRST_ID 4
+
+// draw priorities, lower values get lower OAM slots
+#define SPR_PRI_HUD	0	// always drawn first
+#define SPR_PRI_PLAYER	1
+#define SPR_PRI_ACTOR	2	// rotated each frame so overloaded
+				// scanlines flicker instead of dropping
+				// the same sprites every frame
+
+// compiled metasprite, see mkmetaspr.py
+// draws at metaspr_x,metaspr_y from OAM offset id
+typedef void (*metaspr_fn)(byte id);
+
+// start collecting draw requests for this frame
+void spr_begin(void);
+
+// ask for metasprite data to be drawn at x,y
+// requests past SPR_MAX_REQ are dropped
+void spr_request(byte x, byte y, const unsigned char* data, byte pri);
+
+// same, with a compiled metasprite of len hardware sprites
+void spr_request_fn(byte x, byte y, metaspr_fn fn, byte len, byte pri);
+
+// write this frame's requests to OAM by priority,
+// hide the slots the last frame used that this one didn't,
+// and return the OAM byte after the last sprite drawn
+// (0 when OAM is full)
+byte spr_end(void);
+
+#endif // sprites.h
@@ -0,0 +1,23 @@
+
+// generated by mktitle.py from flappyBird_titlescreen.h, do not edit
+// 1024 bytes of nametable in 223 bytes of LZ4 (the RLE was 327)
+// match offsets are at most 32
+
+#define TITLE_SIZE 1024
+
+const unsigned char title_lz4[223]={
+0x1f,0x97,0x01,0x00,0x0c,0x1f,0xb0,0x01,0x00,0x0c,0x1f,0x94,0x01,0x00,0x36,0xaf,
+0x09,0x0a,0x0b,0x0c,0x0d,0x0e,0x0f,0x22,0x23,0x24,0x20,0x00,0x03,0xaf,0x19,0x1a,
+0x1b,0x1c,0x1d,0x1e,0x1f,0x32,0x33,0x34,0x20,0x00,0x03,0xbf,0x29,0x2a,0x2b,0x2c,
+0x2d,0x2e,0x2f,0x42,0x43,0x44,0x94,0x01,0x00,0x06,0x6f,0x3d,0x3e,0x40,0x41,0x53,
+0x54,0x20,0x00,0x07,0x8f,0x94,0x35,0x36,0x37,0x38,0x39,0x94,0x3b,0x20,0x00,0x06,
+0x7f,0x45,0x46,0x47,0x48,0x49,0x4a,0x4b,0x20,0x00,0x06,0x8f,0x55,0x56,0x57,0x58,
+0x59,0x5a,0x5b,0x94,0x01,0x00,0x76,0x3f,0xc3,0xc4,0xc5,0x06,0x00,0x07,0x9f,0xc3,
+0xc4,0xc5,0xd3,0xd4,0xd5,0xd0,0xd1,0xd2,0x06,0x00,0x02,0x6f,0xd2,0xd3,0xd3,0xd4,
+0xd5,0xbd,0x01,0x00,0x0c,0x3f,0xba,0xbb,0xbc,0x04,0x00,0x0a,0x4f,0xca,0xcb,0xcc,
+0xcd,0x04,0x00,0x09,0x4f,0xb6,0xb7,0xb8,0xb9,0x04,0x00,0x09,0x5f,0xb1,0xb2,0xb3,
+0xb4,0xb5,0x05,0x00,0x08,0x1f,0x96,0x01,0x00,0x4c,0x1f,0xb0,0x01,0x00,0x0c,0x1f,
+0x97,0x01,0x00,0x6c,0x40,0x0a,0x8a,0xaa,0x0a,0x01,0x00,0x48,0x00,0x00,0x02,0x00,
+0x01,0x00,0x93,0xff,0xcf,0x3f,0xff,0xc3,0x30,0xf2,0xf0,0xff,0x01,0x00,0x13,0xa5,
+0x01,0x00,0x13,0xaa,0x01,0x00,0x80,0x0a,0x0a,0x0a,0x0a,0x0a,0x0a,0x0a,0x0a,
+};
@@ -6,17 +6,51 @@
 // index to end of buffer
 byte updptr = 0;
 
+// entries deferred to a later frame, oldest first,
+// each one after a byte with its priority
+static byte spillbuf[VBUF_SPILLSIZE];
+// index to end of spill buffer
+static byte spillptr = 0;
+
+// bytes of scroll entries queued this frame
+static byte scroll_used;
+
+// size of the update buffer entry at p
+static byte entry_len(const byte* p) {
+  // non-sequential writes are MSB, LSB, byte
+  return p[0] < NT_UPD_HORZ ? 3 : 3 + p[2];
+}
+
 // add EOF marker to buffer (but don't increment pointer)
 void vrambuf_end(void) {
   VRAMBUF_SET(NT_UPD_EOF);
 }
 
 // clear vram buffer and place EOF marker
+// deferred entries are carried over first, in order,
+// as long as they fit their priority's share
 void vrambuf_clear(void) {
+  byte n;
   updptr = 0;
+  scroll_used = 0;
+  while (spillptr) {
+    n = entry_len(spillbuf+1);
+    if (vrambuf_avail(spillbuf[0]) < n)
+      break;
+    memcpy(updbuf+updptr, spillbuf+1, n);
+    updptr += n;
+    spillptr -= n+1;
+    memmove(spillbuf, spillbuf+n+1, spillptr);
+  }
   vrambuf_end();
 }
 
+// clear vram buffer and drop deferred entries
+void vrambuf_reset(void) {
+  spillptr = 0;
+  vrambuf_clear();
+}
+
 // wait for next frame, then clear buffer
 // this assumes the NMI will call flush_vram_update()
 void vrambuf_flush(void) {
@@ -29,21 +63,65 @@ void vrambuf_flush(void) {
   vrambuf_clear();
 }
 
-// add multiple characters to update buffer
-// using horizontal increment
-void vrambuf_put(word addr, register const char* str, byte len) {
-  // if bytes won't fit, wait for vsync and flush buffer
-  if (VBUFSIZE-4-len < updptr) {
-    vrambuf_flush();
+// bytes left this frame for updates of priority pri
+byte vrambuf_avail(byte pri) {
+  byte limit = VBUFSIZE-1;
+  // room the scroll entries may still need
+  if (pri != VRAMBUF_PRI_SCROLL && scroll_used < VBUF_SCROLL_RESERVE)
+    limit -= VBUF_SCROLL_RESERVE - scroll_used;
+  if (pri == VRAMBUF_PRI_COSMETIC)
+    limit -= VBUF_HUD_RESERVE;
+  return updptr < limit ? limit-updptr : 0;
+}
+
+// allocate n raw bytes in update buffer
+// if they won't fit this frame, defer them to the next
+// (scroll entries always go in this frame)
+char* vrambuf_alloc(byte n, byte pri) {
+  char* dest;
+  if (pri == VRAMBUF_PRI_SCROLL) {
+    // only if the reserve was too small, wait for vsync and flush
+    while (vrambuf_avail(pri) < n)
+      vrambuf_flush();
+    scroll_used += n;
+  } else {
+    // queue behind anything already deferred
+    while (spillptr || vrambuf_avail(pri) < n) {
+      if (VBUF_SPILLSIZE-1-n >= spillptr) {
+        spillbuf[spillptr] = pri;
+        dest = (char*)spillbuf+spillptr+1;
+        spillptr += n+1;
+        return dest;
+      }
+      // nowhere to defer to, wait for vsync and flush buffer
+      vrambuf_flush();
+    }
   }
+  dest = (char*)updbuf+updptr;
+  updptr += n;
+  return dest;
+}
+
+// reserve room for len bytes at addr in update buffer
+// using horizontal increment (OR addr with VRAMBUF_VERT
+// for vertical), returns pointer for the caller to fill
+// caller must call vrambuf_end() when done
+char* vrambuf_reserve(word addr, byte len, byte pri) {
+  char* dest = vrambuf_alloc(len+3, pri);
   // add vram address
-  VRAMBUF_ADD((addr >> 8) ^ NT_UPD_HORZ);
-  VRAMBUF_ADD(addr); // only lower 8 bits
+  dest[0] = (addr >> 8) ^ NT_UPD_HORZ;
+  dest[1] = addr; // only lower 8 bits
   // add length
-  VRAMBUF_ADD(len);
+  dest[2] = len;
+  // caller fills data in place
+  return dest+3;
+}
+
+// add multiple characters to update buffer
+// using horizontal increment
+void vrambuf_put(word addr, register const char* str, byte len) {
   // add data to buffer
-  memcpy(updbuf+updptr, str, len);
-  updptr += len;
+  memcpy(vrambuf_reserve(addr, len, VRAMBUF_PRI_SCROLL), str, len);
   // place EOF mark
   vrambuf_end();
 }
@@ -4,8 +4,43 @@
 
 #include "neslib.h"
 
-// VBUFSIZE = maximum update buffer bytes
-#define VBUFSIZE 128
+// NMI cycles in vblank, and what the NMI spends there besides
+// the update buffer: OAM DMA, a palette update (when pal_col,
+// pal_bright or a fade asked for one), entry, scroll and exit
+#define VBLANK_CYCLES	2273
+#define NMI_OAM_CYCLES	520
+#define NMI_PAL_CYCLES	350
+#define NMI_MISC_CYCLES	100
+
+// NMI cycles per update buffer byte, runs and single writes alike
+#define VBUF_BYTE_CYCLES 16
+
+// VBUFSIZE = maximum update buffer bytes, EOF marker included
+// (what the NMI can upload in what's left of vblank)
+#define VBUFSIZE ((VBLANK_CYCLES - NMI_OAM_CYCLES - NMI_PAL_CYCLES \
+                   - NMI_MISC_CYCLES) / VBUF_BYTE_CYCLES)
+
+// VBUF_SPILLSIZE = bytes of entries that can wait for later frames
+// (each one also keeps its priority in a byte)
+#define VBUF_SPILLSIZE 64
+
+// share of the buffer HUD and cosmetic entries leave for scroll
+// entries each frame (a 27-byte column plus 6 attribute writes)
+#define VBUF_SCROLL_RESERVE (VBUFSIZE*5/8)
+
+// share cosmetic entries leave for the HUD (a 6-digit run)
+#define VBUF_HUD_RESERVE (VBUFSIZE/8)
+
+// update priorities
+// scroll entries can use the whole buffer and are never deferred,
+// a column a frame late is already scrolling into view; the others
+// are deferred to later frames when their share runs out, and once
+// anything is deferred new entries queue behind it, so writes to
+// the same address reach the PPU in order
+// (a HUD or cosmetic entry must fit in its share of an empty buffer)
+#define VRAMBUF_PRI_SCROLL	0	// playfield columns and attributes
+#define VRAMBUF_PRI_HUD		1	// score digits
+#define VRAMBUF_PRI_COSMETIC	2	// anything else
 
 // update buffer starts at $100 (stack page)
 #define updbuf ((byte*)0x100)
@@ -30,14 +65,30 @@ extern byte updptr;
 void vrambuf_end(void);
 
 // clear vram buffer and place EOF marker
+// entries deferred from earlier frames go in first
 void vrambuf_clear(void);
 
+// clear vram buffer and drop deferred entries
+void vrambuf_reset(void);
+
 // wait for next frame, then clear buffer
 // this assumes the NMI will call flush_vram_update()
 void vrambuf_flush(void);
 
+// bytes left this frame for updates of priority pri
+byte vrambuf_avail(byte pri);
+
+// allocate n raw bytes of update buffer entries
+// deferred to the next frame if they don't fit this one
+char* vrambuf_alloc(byte n, byte pri);
+
+// reserve room for len bytes at addr in update buffer
+// returns pointer for the caller to fill in place,
+// then call vrambuf_end() to place the EOF marker
+char* vrambuf_reserve(word addr, byte len, byte pri);
+
 // add multiple characters to update buffer
-// using horizontal increment
+// using horizontal increment (scroll priority)
 void vrambuf_put(word addr, const char* str, byte len);
 
 #endif // vrambuf.h